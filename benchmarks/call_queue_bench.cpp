@@ -0,0 +1,130 @@
+/**
+ * @file call_queue_bench.cpp
+ * @author Pele Constam (pelectron1602@gmail.com)
+ * @brief Compares handing calls from producer threads to a consumer thread
+ * through spsc_call_queue/mpsc_call_queue with a mutex guarded std::deque of
+ * delegate<void()>. Reports the throughput and the latency percentiles from
+ * pushing a call to running it.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "call_queue.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using clock_type = std::chrono::steady_clock;
+
+static constexpr size_t num_calls = 1u << 20;
+static constexpr size_t queue_capacity = 1024;
+
+/// latencies of the calls run so far, in nanoseconds.
+struct Recorder {
+  std::vector<long long> latencies;
+  long                   checksum{0};
+};
+
+/// a call as handed over by the producers. 40 bytes of captures, i.e. too big
+/// for the inline storage of a delegate.
+auto make_call(Recorder& recorder, long a) {
+  return [&recorder, start = clock_type::now(), a, b = a * 2, c = a * 3] {
+    recorder.checksum += a + b + c;
+    recorder.latencies.push_back(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            clock_type::now() - start)
+            .count());
+  };
+}
+
+/// runs num_producers threads pushing num_calls calls in total with push,
+/// while the calling thread runs them with run_some.
+template <typename Push, typename RunSome>
+void measure(const char* name, unsigned num_producers, Push push,
+             RunSome run_some, Recorder& recorder) {
+  recorder.latencies.clear();
+  recorder.latencies.reserve(num_calls);
+  const size_t             per_producer = num_calls / num_producers;
+  const auto               start = clock_type::now();
+  std::vector<std::thread> producers;
+  for (unsigned p = 0; p < num_producers; ++p) {
+    producers.emplace_back([&] {
+      for (size_t i = 0; i < per_producer; ++i) {
+        while (!push(static_cast<long>(i)))
+          std::this_thread::yield();
+      }
+    });
+  }
+  while (recorder.latencies.size() < per_producer * num_producers)
+    run_some();
+  const auto stop = clock_type::now();
+  for (auto& t : producers)
+    t.join();
+
+  auto& l = recorder.latencies;
+  std::sort(l.begin(), l.end());
+  const double seconds = std::chrono::duration<double>(stop - start).count();
+  std::printf("%-24s %10u %14.0f %10lld %10lld %10lld\n", name, num_producers,
+              l.size() / seconds, l[l.size() / 2], l[l.size() * 99 / 100],
+              l[l.size() * 999 / 1000]);
+}
+
+int main() {
+  Recorder recorder;
+  std::printf("%-24s %10s %14s %10s %10s %10s\n", "queue", "producers",
+              "calls/s", "p50 [ns]", "p99 [ns]", "p99.9 [ns]");
+  {
+    pc::spsc_call_queue queue(queue_capacity);
+    measure(
+        "spsc_call_queue", 1,
+        [&](long a) { return queue.try_push(make_call(recorder, a)); },
+        [&] { queue.drain(64); }, recorder);
+  }
+  const unsigned hw = std::max(2u, std::thread::hardware_concurrency());
+  for (unsigned producers = 1; producers < hw; producers *= 2) {
+    pc::mpsc_call_queue queue(queue_capacity);
+    measure(
+        "mpsc_call_queue", producers,
+        [&](long a) { return queue.try_push(make_call(recorder, a)); },
+        [&] { queue.drain(64); }, recorder);
+
+    // baseline: every push binds a delegate<void()>, which heap allocates
+    // the call, and takes the same mutex as the consumer.
+    std::mutex                        m;
+    std::deque<pc::delegate<void()>>  tasks;
+    std::vector<pc::delegate<void()>> batch;
+    measure(
+        "mutex + deque<delegate>", producers,
+        [&](long a) {
+          pc::delegate<void()>        task(make_call(recorder, a));
+          std::lock_guard<std::mutex> lock(m);
+          if (tasks.size() >= queue_capacity)
+            return false;
+          tasks.push_back(std::move(task));
+          return true;
+        },
+        [&] {
+          {
+            std::lock_guard<std::mutex> lock(m);
+            while (!tasks.empty() && batch.size() < 64) {
+              batch.push_back(std::move(tasks.front()));
+              tasks.pop_front();
+            }
+          }
+          for (auto& task : batch)
+            task();
+          batch.clear();
+        },
+        recorder);
+  }
+  return recorder.checksum == 42 ? 1 : 0;
+}
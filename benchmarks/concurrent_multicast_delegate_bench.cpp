@@ -0,0 +1,92 @@
+/**
+ * @file concurrent_multicast_delegate_bench.cpp
+ * @author Pele Constam (pelectron1602@gmail.com)
+ * @brief Compares the emit throughput of concurrent_multicast_delegate with a
+ * mutex guarded multicast_delegate while another thread keeps binding and
+ * unbinding callables.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "concurrent_multicast_delegate.hpp"
+#include "multicast_delegate.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static constexpr int                       num_subscribers = 8;
+static constexpr std::chrono::milliseconds run_time{300};
+
+thread_local long sink = 0;
+static void       subscriber(int a) { sink += a; }
+
+/// runs emit on num_threads threads while churn runs on one more thread.
+/// \return emits per second summed over all emitting threads.
+template <typename Emit, typename Churn>
+double measure(unsigned num_threads, Emit emit, Churn churn) {
+  std::atomic<bool>        stop{false};
+  std::atomic<long>        total{0};
+  std::vector<std::thread> threads;
+  for (unsigned i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&] {
+      long n = 0;
+      while (!stop.load(std::memory_order_relaxed)) {
+        emit();
+        ++n;
+      }
+      total += n;
+    });
+  }
+  std::thread churner([&] {
+    while (!stop.load(std::memory_order_relaxed))
+      churn();
+  });
+  std::this_thread::sleep_for(run_time);
+  stop = true;
+  for (auto& t : threads)
+    t.join();
+  churner.join();
+  return static_cast<double>(total.load()) /
+         std::chrono::duration<double>(run_time).count();
+}
+
+int main() {
+  const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+  std::printf("%8s %20s %20s\n", "threads", "mutex [emits/s]",
+              "concurrent [emits/s]");
+  for (unsigned threads = 1; threads <= hw; threads *= 2) {
+    // baseline: every emit and every modification takes the same mutex.
+    pc::multicast_delegate<void(int)> guarded;
+    std::mutex                        m;
+    for (int i = 0; i < num_subscribers; ++i)
+      guarded.bind(&subscriber);
+    double mutex_rate = measure(
+        threads,
+        [&] {
+          std::lock_guard<std::mutex> lock(m);
+          guarded(1);
+        },
+        [&] {
+          std::lock_guard<std::mutex> lock(m);
+          guarded.unbind(guarded.bind(&subscriber));
+        });
+
+    pc::concurrent_multicast_delegate<void(int)> concurrent;
+    for (int i = 0; i < num_subscribers; ++i)
+      concurrent.bind(&subscriber);
+    double concurrent_rate =
+        measure(threads, [&] { concurrent(1); },
+                [&] { concurrent.unbind(concurrent.bind(&subscriber)); });
+
+    std::printf("%8u %20.0f %20.0f\n", threads, mutex_rate, concurrent_rate);
+  }
+}
@@ -0,0 +1,114 @@
+/**
+ * @file event_bus_bench.cpp
+ * @author Pele Constam (pelectron1602@gmail.com)
+ * @brief Compares publishing through an event_bus with looking up the channel
+ * in an unordered_map keyed by event id, for 10 to 10000 event types.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "event_bus.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+static constexpr size_t publishes_per_run = 1u << 23;
+
+template <size_t I>
+struct Event : pc::event<I, void(int)> {};
+
+static long sink = 0;
+
+void subscriber(int a) { sink += a; }
+
+template <typename F>
+double publishes_per_second(size_t num_events, F publish_all) {
+  const size_t rounds = publishes_per_run / num_events;
+  const auto   start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < rounds; ++i)
+    publish_all(static_cast<int>(i));
+  const auto stop = std::chrono::steady_clock::now();
+  return rounds * num_events /
+         std::chrono::duration<double>(stop - start).count();
+}
+
+// the events are subscribed and published in blocks of at most block_size
+// events, each expanded into an array rather than a fold expression. Compilers
+// handle single functions with thousands of calls, and fold expressions over
+// thousands of events, in quadratic time.
+static constexpr size_t block_size = 100;
+
+template <size_t First, typename Bus, size_t... I>
+void subscribe_block(Bus &bus, std::index_sequence<I...>) {
+  const size_t ids[] = {
+      bus.template subscribe<Event<First + I>>(&subscriber)...};
+  (void)ids;
+}
+
+template <size_t First, typename Bus, size_t... I>
+void publish_block(Bus &bus, int a, std::index_sequence<I...>) {
+  const bool published[] = {
+      (bus.template publish<Event<First + I>>(a), true)...};
+  (void)published;
+}
+
+template <typename Bus, size_t... B>
+void subscribe_all(Bus &bus, std::index_sequence<B...>) {
+  constexpr size_t n = std::min(block_size, Bus::num_events());
+  const bool subscribed[] = {
+      (subscribe_block<B * n>(bus, std::make_index_sequence<n>{}), true)...};
+  (void)subscribed;
+}
+
+template <typename Bus, size_t... B>
+void publish_all(Bus &bus, int a, std::index_sequence<B...>) {
+  constexpr size_t n = std::min(block_size, Bus::num_events());
+  const bool published[] = {
+      (publish_block<B * n>(bus, a, std::make_index_sequence<n>{}), true)...};
+  (void)published;
+}
+
+template <size_t... I>
+void run(std::index_sequence<I...>) {
+  constexpr size_t num_events = sizeof...(I);
+  constexpr size_t num_blocks =
+      num_events / std::min(block_size, num_events);
+  static_assert(num_events % std::min(block_size, num_events) == 0,
+                "the number of events must be a multiple of block_size.");
+  using blocks = std::make_index_sequence<num_blocks>;
+
+  using bus_t = pc::event_bus<Event<I>...>;
+  auto bus = std::make_unique<bus_t>();
+  subscribe_all(*bus, blocks{});
+
+  std::unordered_map<size_t, pc::multicast_delegate<void(int)>> map;
+  for (size_t id = 0; id < num_events; ++id)
+    map[id].bind(&subscriber);
+
+  const double bus_rate = publishes_per_second(
+      num_events, [&](int a) { publish_all(*bus, a, blocks{}); });
+  const double map_rate = publishes_per_second(num_events, [&](int a) {
+    for (size_t id = 0; id < num_events; ++id)
+      map.find(id)->second(a);
+  });
+  std::printf("%12zu %24.0f %24.0f %8.2f\n", num_events, map_rate, bus_rate,
+              bus_rate / map_rate);
+}
+
+int main() {
+  std::printf("%12s %24s %24s %8s\n", "events", "unordered_map [pub/s]",
+              "event_bus [pub/s]", "ratio");
+  run(std::make_index_sequence<10>{});
+  run(std::make_index_sequence<100>{});
+  run(std::make_index_sequence<1000>{});
+  run(std::make_index_sequence<10000>{});
+  return sink == 42 ? 1 : 0;
+}
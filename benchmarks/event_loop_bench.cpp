@@ -0,0 +1,92 @@
+/**
+ * @file event_loop_bench.cpp
+ * @author Pele Constam (pelectron1602@gmail.com)
+ * @brief Measures the events per second dispatched by the event_loop. A ring
+ * of pipes passes tokens along: each handler reads a token from its pipe and
+ * writes it to the next one, so every token causes one readiness event per
+ * hop. Also measures the tasks per second posted from another thread.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "event_loop.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+static constexpr size_t num_events = 2'000'000;
+static constexpr size_t num_tasks = 10'000'000;
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+/// passes num_pipes / 2 tokens around a ring of num_pipes pipes until
+/// num_events events were dispatched. Returns the events per second.
+double pipe_ring(size_t num_pipes) {
+  std::vector<int> fds(2 * num_pipes);
+  for (size_t i = 0; i < num_pipes; ++i) {
+    if (pipe2(&fds[2 * i], O_NONBLOCK) != 0)
+      return 0;
+  }
+  pc::event_loop loop;
+  size_t         events = 0;
+  for (size_t i = 0; i < num_pipes; ++i) {
+    const int next = fds[2 * ((i + 1) % num_pipes) + 1];
+    loop.add(fds[2 * i], EPOLLIN, [&events, next](int fd, uint32_t) {
+      char token;
+      while (read(fd, &token, 1) == 1) {
+        (void)!write(next, &token, 1);
+        ++events;
+      }
+    });
+  }
+  const char token = 't';
+  for (size_t i = 0; i < num_pipes; i += 2)
+    (void)!write(fds[2 * i + 1], &token, 1);
+
+  const auto start = std::chrono::steady_clock::now();
+  while (events < num_events)
+    loop.run_once();
+  const double s = seconds_since(start);
+  for (int fd : fds)
+    close(fd);
+  return events / s;
+}
+
+/// posts num_tasks tasks from another thread. Returns the tasks per second.
+double posted_tasks() {
+  pc::event_loop   loop;
+  std::atomic<int> done{0};
+  size_t           count = 0;
+  const auto       start = std::chrono::steady_clock::now();
+  std::thread      poster([&] {
+    for (size_t i = 0; i < num_tasks; ++i)
+      loop.post([&count] { ++count; });
+    loop.post([&done] { done.store(1); });
+  });
+  while (done.load() == 0)
+    loop.run_once();
+  const double s = seconds_since(start);
+  poster.join();
+  return count / s;
+}
+
+int main() {
+  std::printf("%10s %16s\n", "pipes", "events/s");
+  for (size_t pipes : {2, 16, 128, 256})
+    std::printf("%10zu %16.0f\n", pipes, pipe_ring(pipes));
+  std::printf("%10s %16.0f\n", "posted", posted_tasks());
+}
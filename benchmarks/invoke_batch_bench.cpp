@@ -0,0 +1,72 @@
+/**
+ * @file invoke_batch_bench.cpp
+ * @author Pele Constam (pelectron1602@gmail.com)
+ * @brief Compares multicast_delegate::invoke_batch() with one operator() call
+ * per event for 1 to 1000 callables.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "multicast_delegate.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+static constexpr size_t batch_size = 256;
+static constexpr size_t events_per_run = 1u << 20;
+
+/// callables with distinct code, so that many of them compete for the
+/// instruction cache.
+template <size_t K>
+struct Subscriber {
+  void operator()(int a, float b) {
+    state = state * (K + 3) + static_cast<long>(a * b) % (K + 7);
+  }
+  long state{K};
+};
+
+template <size_t... K>
+void bind_subscribers(pc::multicast_delegate<void(int, float)>& del,
+                      size_t count, std::index_sequence<K...>) {
+  for (size_t i = 0; i < count; i += sizeof...(K))
+    (del.bind(Subscriber<K>{}), ...);
+}
+
+template <typename F>
+double events_per_second(F f) {
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < events_per_run; i += batch_size)
+    f();
+  const auto stop = std::chrono::steady_clock::now();
+  return events_per_run / std::chrono::duration<double>(stop - start).count();
+}
+
+int main() {
+  std::vector<std::tuple<int, float>> events;
+  for (size_t i = 0; i < batch_size; ++i)
+    events.emplace_back(static_cast<int>(i), 0.5f * i);
+
+  std::printf("%12s %20s %20s %8s\n", "callables", "per event [ev/s]",
+              "batched [ev/s]", "ratio");
+  for (size_t count : {1, 10, 100, 1000}) {
+    pc::multicast_delegate<void(int, float)> del;
+    if (count == 1)
+      del.bind(Subscriber<0>{});
+    else
+      bind_subscribers(del, count, std::make_index_sequence<10>{});
+    const double per_event = events_per_second([&] {
+      for (const auto& [a, b] : events)
+        del(a, b);
+    });
+    const double batched = events_per_second([&] { del.invoke_batch(events); });
+    std::printf("%12zu %20.0f %20.0f %8.2f\n", count, per_event, batched,
+                batched / per_event);
+  }
+}
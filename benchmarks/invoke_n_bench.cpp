@@ -0,0 +1,77 @@
+/**
+ * @file invoke_n_bench.cpp
+ * @author Pele Constam (pelectron1602@gmail.com)
+ * @brief Compares processing arrays element by element through a
+ * delegate<float(int, float)> with delegate::invoke_n(), once for a function
+ * object called per element and once for one with a vectorized overload.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "delegate.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+static constexpr size_t batch_size = 4096;
+static constexpr size_t elements_per_run = 1u << 28;
+
+/// the element-wise callback.
+struct Multiply {
+  float operator()(int a, float b) const { return a * b + 1.0f; }
+};
+
+/// the same callback with a vectorized overload.
+struct BulkMultiply : Multiply {
+  using bulk_overload = void;
+  using Multiply::operator();
+  void operator()(pc::bulk_t, pc::span<const int> a, pc::span<const float> b,
+                  pc::span<float> out) const {
+    const int*   pa = a.data();
+    const float* pb = b.data();
+    float*       po = out.data();
+    for (size_t i = 0; i < out.size(); ++i)
+      po[i] = pa[i] * pb[i] + 1.0f;
+  }
+};
+
+template <typename F>
+double elements_per_second(F f) {
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < elements_per_run; i += batch_size)
+    f();
+  const auto stop = std::chrono::steady_clock::now();
+  return elements_per_run / std::chrono::duration<double>(stop - start).count();
+}
+
+int main() {
+  std::vector<int>   a(batch_size);
+  std::vector<float> b(batch_size);
+  std::vector<float> out(batch_size);
+  for (size_t i = 0; i < batch_size; ++i) {
+    a[i] = static_cast<int>(i % 97);
+    b[i] = 0.25f * (i % 13);
+  }
+  pc::delegate<float(int, float)> scalar{Multiply{}};
+  pc::delegate<float(int, float)> vectorized{BulkMultiply{}};
+
+  const double per_element = elements_per_second([&] {
+    for (size_t i = 0; i < batch_size; ++i)
+      out[i] = scalar(a[i], b[i]);
+  });
+  const double batched =
+      elements_per_second([&] { scalar.invoke_n(a, b, out); });
+  const double bulk =
+      elements_per_second([&] { vectorized.invoke_n(a, b, out); });
+
+  std::printf("%20s %16s\n", "", "elements/s");
+  std::printf("%20s %16.0f\n", "per element", per_element);
+  std::printf("%20s %16.0f\n", "invoke_n", batched);
+  std::printf("%20s %16.0f\n", "invoke_n vectorized", bulk);
+  std::printf("%20s %16f\n", "checksum", out[batch_size - 1]);
+}
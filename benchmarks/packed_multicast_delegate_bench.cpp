@@ -0,0 +1,81 @@
+/**
+ * @file packed_multicast_delegate_bench.cpp
+ * @author Pele Constam (pelectron1602@gmail.com)
+ * @brief Compares invoking a multicast_delegate, a packed_multicast_delegate
+ * and a packed_multicast_delegate grouped by target, with an interleaved mix
+ * of free functions, member functions and function objects bound.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "multicast_delegate.hpp"
+#include "packed_multicast_delegate.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+static constexpr size_t calls_per_run = 1u << 24;
+
+static long sink = 0;
+
+void free_a(int a) { sink += a; }
+void free_b(int a) { sink ^= a; }
+
+struct Counter {
+  void count(int a) { total += a; }
+  long total{0};
+};
+
+struct Functor {
+  void operator()(int a) { sink -= a + k; }
+  int k;
+};
+
+/// bind count callables of randomly mixed kinds to del.
+template <typename Delegate>
+void bind_mixed(Delegate& del, size_t count, Counter& counter) {
+  std::mt19937 gen(42);
+  for (size_t i = 0; i < count; ++i) {
+    switch (gen() % 4) {
+    case 0: del.bind(&free_a); break;
+    case 1: del.bind(&free_b); break;
+    case 2: del.bind(counter, &Counter::count); break;
+    default: del.bind(Functor{static_cast<int>(i)}); break;
+    }
+  }
+}
+
+template <typename Delegate>
+double calls_per_second(Delegate& del, size_t count) {
+  const size_t runs = calls_per_run / count;
+  const auto   start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < runs; ++i)
+    del(static_cast<int>(i));
+  const auto stop = std::chrono::steady_clock::now();
+  return runs * count / std::chrono::duration<double>(stop - start).count();
+}
+
+int main() {
+  std::printf("%12s %20s %20s %20s\n", "callables", "multicast [calls/s]",
+              "packed [calls/s]", "grouped [calls/s]");
+  for (size_t count : {8, 64, 512, 4096}) {
+    Counter                                  counter;
+    pc::multicast_delegate<void(int)>        multicast;
+    pc::packed_multicast_delegate<void(int)> packed;
+    pc::packed_multicast_delegate<void(int)> grouped;
+    bind_mixed(multicast, count, counter);
+    bind_mixed(packed, count, counter);
+    bind_mixed(grouped, count, counter);
+    grouped.group_by_target();
+    const double m = calls_per_second(multicast, count);
+    const double p = calls_per_second(packed, count);
+    const double g = calls_per_second(grouped, count);
+    std::printf("%12zu %20.0f %20.0f %20.0f\n", count, m, p, g);
+  }
+  return sink == 42 ? 1 : 0;
+}
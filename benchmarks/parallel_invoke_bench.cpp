@@ -0,0 +1,72 @@
+/**
+ * @file parallel_invoke_bench.cpp
+ * @author Pele Constam (pelectron1602@gmail.com)
+ * @brief Compares the latency of multicast_delegate::parallel_invoke() with
+ * the serial operator() for a large number of CPU heavy callables.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "multicast_delegate.hpp"
+#include "thread_pool.hpp"
+
+#include <chrono>
+#include <cstdio>
+
+static constexpr int num_subscribers = 2000;
+static constexpr int num_runs = 10;
+
+struct Frame {
+  double data[16];
+};
+
+/// some CPU bound work per callable.
+struct Subscriber {
+  double operator()(const Frame& frame) {
+    double acc = seed;
+    for (int i = 0; i < 2000; ++i)
+      acc = acc * 0.999 + frame.data[i % 16];
+    return acc;
+  }
+  double seed;
+};
+
+template <typename F>
+double average_ms(F f) {
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_runs; ++i)
+    f();
+  const auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count() /
+         num_runs;
+}
+
+int main() {
+  pc::multicast_delegate<double(const Frame&)> del;
+  for (int i = 0; i < num_subscribers; ++i)
+    del.bind(Subscriber{static_cast<double>(i)});
+  Frame frame{};
+  for (int i = 0; i < 16; ++i)
+    frame.data[i] = i * 0.5;
+
+  const double serial = average_ms([&] {
+    del.clear_results();
+    del(frame);
+  });
+  std::printf("%d callables, serial: %.3f ms\n", num_subscribers, serial);
+  std::printf("%8s %14s %10s\n", "threads", "parallel [ms]", "speedup");
+  const size_t hw = pc::thread_pool::default_num_threads();
+  for (size_t threads = 1; threads <= hw; threads *= 2) {
+    // the calling thread takes part in the invocation, so threads - 1 workers
+    pc::thread_pool pool(threads > 1 ? threads - 1 : 1);
+    const double    parallel = average_ms([&] {
+      del.clear_results();
+      del.parallel_invoke(pool, frame);
+    });
+    std::printf("%8zu %14.3f %10.2f\n", threads, parallel, serial / parallel);
+  }
+}
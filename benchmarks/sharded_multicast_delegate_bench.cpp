@@ -0,0 +1,86 @@
+/**
+ * @file sharded_multicast_delegate_bench.cpp
+ * @author Pele Constam (pelectron1602@gmail.com)
+ * @brief Compares the emit throughput of sharded_multicast_delegate with a
+ * mutex guarded multicast_delegate when every thread emits and collects the
+ * returned values.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "multicast_delegate.hpp"
+#include "sharded_multicast_delegate.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static constexpr int                       num_subscribers = 8;
+static constexpr std::chrono::milliseconds run_time{300};
+
+static int subscriber(int a) { return a + 1; }
+
+/// runs emit on num_threads threads. drain is called every 1024 emits.
+/// \return emits per second summed over all threads.
+template <typename Emit, typename Drain>
+double measure(unsigned num_threads, Emit emit, Drain drain) {
+  std::atomic<bool>        stop{false};
+  std::atomic<long>        total{0};
+  std::vector<std::thread> threads;
+  for (unsigned i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&] {
+      long n = 0;
+      while (!stop.load(std::memory_order_relaxed)) {
+        emit();
+        if ((++n & 1023) == 0)
+          drain();
+      }
+      total += n;
+    });
+  }
+  std::this_thread::sleep_for(run_time);
+  stop = true;
+  for (auto& t : threads)
+    t.join();
+  return static_cast<double>(total.load()) /
+         std::chrono::duration<double>(run_time).count();
+}
+
+int main() {
+  const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+  std::printf("%8s %20s %20s\n", "threads", "mutex [emits/s]",
+              "sharded [emits/s]");
+  for (unsigned threads = 1; threads <= hw; threads *= 2) {
+    // baseline: one subscriber list and one results vector behind one mutex.
+    pc::multicast_delegate<int(int)> guarded;
+    std::mutex                       m;
+    for (int i = 0; i < num_subscribers; ++i)
+      guarded.bind(&subscriber);
+    const double mutex_rate = measure(
+        threads,
+        [&] {
+          std::lock_guard<std::mutex> lock(m);
+          guarded(1);
+        },
+        [&] {
+          std::lock_guard<std::mutex> lock(m);
+          guarded.clear_results();
+        });
+
+    pc::sharded_multicast_delegate<int(int)> sharded;
+    for (int i = 0; i < num_subscribers; ++i)
+      sharded.bind(&subscriber);
+    const double sharded_rate = measure(
+        threads, [&] { sharded(1); }, [&] { sharded.clear_results(); });
+
+    std::printf("%8u %20.0f %20.0f\n", threads, mutex_rate, sharded_rate);
+  }
+}
@@ -0,0 +1,89 @@
+/**
+ * @file task_scheduler_bench.cpp
+ * @author Pele Constam (pelectron1602@gmail.com)
+ * @brief Fork-join benchmarks of the task_scheduler: a recursive fibonacci
+ * which spawns one task per call above a cutoff, and a parallel_for sum over
+ * a large vector. Both are compared with their serial versions.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "task_scheduler.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+static constexpr int    fib_n = 32;
+static constexpr int    fib_cutoff = 12; //< below this, fib runs serially
+static constexpr size_t sum_size = 1u << 24;
+static constexpr int    num_runs = 5;
+
+long serial_fib(int n) {
+  return n < 2 ? n : serial_fib(n - 1) + serial_fib(n - 2);
+}
+
+long parallel_fib(pc::task_scheduler& s, int n) {
+  if (n < fib_cutoff)
+    return serial_fib(n);
+  pc::wait_group wg;
+  long           a = 0;
+  s.spawn(wg, [&s, &a, n] { a = parallel_fib(s, n - 1); });
+  const long b = parallel_fib(s, n - 2);
+  s.wait(wg);
+  return a + b;
+}
+
+template <typename F>
+double average_ms(F f) {
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_runs; ++i)
+    f();
+  const auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count() /
+         num_runs;
+}
+
+int main() {
+  std::vector<long> values(sum_size);
+  for (size_t i = 0; i < sum_size; ++i)
+    values[i] = static_cast<long>(i % 7);
+
+  volatile long sink = 0;
+  const double  fib_serial = average_ms([&] { sink = serial_fib(fib_n); });
+  const double  sum_serial = average_ms([&] {
+    long total = 0;
+    for (long v : values)
+      total += v;
+    sink = total;
+  });
+  std::printf("serial: fib(%d) %.3f ms, sum of %zu values %.3f ms\n", fib_n,
+              fib_serial, sum_size, sum_serial);
+  std::printf("%8s %12s %10s %12s %10s\n", "threads", "fib [ms]", "speedup",
+              "sum [ms]", "speedup");
+  const size_t hw = pc::task_scheduler::default_num_threads();
+  for (size_t threads = 1; threads <= hw; threads *= 2) {
+    pc::task_scheduler scheduler(threads);
+    const double       fib =
+        average_ms([&] { sink = parallel_fib(scheduler, fib_n); });
+    const double sum = average_ms([&] {
+      std::atomic<long> total{0};
+      scheduler.parallel_for(0, values.size(), 0,
+                             [&](size_t first, size_t last) {
+                               long partial = 0;
+                               for (size_t i = first; i < last; ++i)
+                                 partial += values[i];
+                               total.fetch_add(partial,
+                                               std::memory_order_relaxed);
+                             });
+      sink = total.load();
+    });
+    std::printf("%8zu %12.3f %10.2f %12.3f %10.2f\n", threads, fib,
+                fib_serial / fib, sum, sum_serial / sum);
+  }
+}
@@ -0,0 +1,110 @@
+/**
+ * @file timer_wheel_bench.cpp
+ * @author Pele Constam (pelectron1602@gmail.com)
+ * @brief Compares the timer_wheel with delegates in a std::priority_queue,
+ * where cancelled timers are flagged and skipped when they reach the top.
+ * Simulates connection timeouts: 10M timers are scheduled over time, most of
+ * which are cancelled again before they expire, for several cancellation
+ * rates.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "timer_wheel.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <queue>
+#include <random>
+#include <vector>
+
+static constexpr size_t num_timers = 10'000'000;
+static constexpr size_t timers_per_tick = 100;
+static constexpr size_t max_delay = 30'000; //< in ticks
+
+/// the baseline: a min-heap of delegates, cancelled by sequence number.
+class heap_timers {
+public:
+  template <typename F>
+  uint64_t schedule(uint64_t delay, F&& f) {
+    const uint64_t seq = cancelled.size();
+    cancelled.push_back(false);
+    heap.push(entry{current + delay, seq, pc::delegate<void()>(f)});
+    return seq;
+  }
+
+  void cancel(uint64_t seq) { cancelled[seq] = true; }
+
+  void advance(uint64_t ticks) {
+    current += ticks;
+    while (!heap.empty() && heap.top().expiry <= current) {
+      // top() is const, but the entry is popped right after.
+      auto& top = const_cast<entry&>(heap.top());
+      if (!cancelled[top.seq])
+        top.callback();
+      heap.pop();
+    }
+  }
+
+private:
+  struct entry {
+    uint64_t             expiry;
+    uint64_t             seq;
+    pc::delegate<void()> callback;
+
+    bool operator>(const entry& other) const { return expiry > other.expiry; }
+  };
+
+  std::priority_queue<entry, std::vector<entry>, std::greater<entry>> heap;
+  std::vector<bool> cancelled;
+  uint64_t          current{0};
+};
+
+/// schedules num_timers timers, timers_per_tick per tick, and cancels each
+/// one with probability cancel_percent / 100 at a random later tick before it
+/// expires. Returns the time in seconds and the number of expired timers.
+template <typename Timers>
+double run(Timers& timers, unsigned cancel_percent, size_t& expired) {
+  std::mt19937_64 rng(1);
+  // pending cancellations, indexed by tick modulo max_delay.
+  std::vector<std::vector<uint64_t>> cancel_at(max_delay);
+  expired = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0, tick = 0; i < num_timers; ++tick) {
+    for (size_t j = 0; j < timers_per_tick; ++j, ++i) {
+      const uint64_t delay = 1 + rng() % (max_delay - 1);
+      const uint64_t id = timers.schedule(delay, [&expired] { ++expired; });
+      if (rng() % 100 < cancel_percent)
+        cancel_at[(tick + rng() % delay) % max_delay].push_back(id);
+    }
+    auto& due = cancel_at[tick % max_delay];
+    for (uint64_t id : due)
+      timers.cancel(id);
+    due.clear();
+    timers.advance(1);
+  }
+  timers.advance(max_delay);
+  const auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(stop - start).count();
+}
+
+int main() {
+  std::printf("%10s %16s %16s %10s\n", "cancelled", "heap [ms]",
+              "timer_wheel [ms]", "speedup");
+  for (unsigned cancel_percent : {0u, 50u, 90u, 99u}) {
+    size_t      heap_expired = 0;
+    size_t      wheel_expired = 0;
+    heap_timers heap;
+    const double heap_s = run(heap, cancel_percent, heap_expired);
+    pc::timer_wheel wheel;
+    const double    wheel_s = run(wheel, cancel_percent, wheel_expired);
+    std::printf("%9u%% %16.1f %16.1f %10.2f\n", cancel_percent, heap_s * 1e3,
+                wheel_s * 1e3, heap_s / wheel_s);
+    if (heap_expired != wheel_expired)
+      return 1;
+  }
+}
@@ -102,6 +102,15 @@ int main() {
   my_delegate.bind(big_functor, &BigFunctor::member_func);
   assert(my_delegate(5, 10.0f) == big_functor.member_func(5, 10.0f));
 
+  // whole arrays can be processed with a single indirect call. The lambda is
+  // called directly for each element.
+  my_delegate.bind(lambda);
+  int   as[3]{1, 2, 3};
+  float bs[3]{0.5f, 1.5f, 2.5f};
+  float results[3];
+  my_delegate.invoke_n(as, bs, results);
+  assert(results[2] == lambda(3, 2.5f));
+
   // delegates can be reset, and are invalid afterwards
   my_delegate.reset();
   assert(my_delegate.is_valid() == false);
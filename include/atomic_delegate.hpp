@@ -0,0 +1,296 @@
+/**
+ * \file atomic_delegate.hpp
+ * \author Pele Constam (pelectron1602\gmail.com)
+ * \brief This file defines the \ref pc::atomic_delegate<Ret(Args...)> class, a
+ * delegate which can be rebound while other threads invoke it, and the
+ * quiescent state based reclamation it uses, \ref pc::qsbr_domain and
+ * \ref pc::qsbr_reader.
+ * \version 0.1
+ * \date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef PC_ATOMIC_DELEGATE_HPP
+#define PC_ATOMIC_DELEGATE_HPP
+#include "delegate.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace pc {
+#ifndef GENERATING_DOCUMENTATION
+  /// forward declaration, intentionally left unimplemented.
+  template <typename>
+  class atomic_delegate;
+#endif
+
+  /**
+   * \brief \anchor qsbr-domain-brief quiescent state based reclamation.
+   *
+   * Objects which readers may still use are retired to the domain instead of
+   * being deleted. Reader threads register with a \ref pc::qsbr_reader and
+   * regularly announce a quiescent state, i.e. a point at which they hold no
+   * reference to a retired object, e.g. once per iteration of their event
+   * loop. Announcing copies the domain's epoch into the reader's own slot.
+   *
+   * Retiring an object advances the epoch. The object is deleted once all
+   * registered readers have announced the new epoch or a later one. Reading
+   * a protected pointer therefore costs nothing beyond the load itself; the
+   * price is that a reader which stops announcing keeps retired objects
+   * alive until it does so again or unregisters.
+   *
+   * Retired objects are deleted by retire() and reclaim(), on the calling
+   * thread. The domain's destructor deletes the remaining ones; no reader may
+   * be registered at that point.
+   */
+  class qsbr_domain {
+  public:
+    qsbr_domain() = default;
+    qsbr_domain(const qsbr_domain&) = delete;
+    qsbr_domain& operator=(const qsbr_domain&) = delete;
+    /// destructor. Deletes all retired objects.
+    ~qsbr_domain();
+
+    /// get the process wide default domain.
+    static qsbr_domain& global() {
+      static qsbr_domain domain;
+      return domain;
+    }
+
+    /**
+     * \brief delete object once no registered reader can use it anymore.
+     * Also deletes the objects retired earlier which have become safe.
+     * Thread safe.
+     * \tparam T object type
+     * \param object the object, allocated with new
+     */
+    template <typename T>
+    void retire(T* object);
+
+    /// delete the retired objects which are safe to delete. Thread safe.
+    /// \return size_t number of deleted objects
+    size_t reclaim();
+
+    /// get the number of retired objects not deleted yet.
+    size_t num_retired() const;
+
+  private:
+    friend class qsbr_reader;
+
+    /// the announced epoch of a reader, on its own cache line. 0 means the
+    /// reader is offline.
+    struct alignas(impl::cache_line_size) reader_slot {
+      std::atomic<uint64_t> epoch{0};
+      bool                  used{false}; //< guarded by the domain's mutex
+    };
+
+    /// an object waiting to be deleted.
+    struct retired_object {
+      void* object;
+      void (*deleter)(void*);
+      uint64_t epoch; //< readers must have announced this epoch
+    };
+
+    /// delete the safe objects. mutex must be held.
+    size_t reclaim_locked();
+
+    std::atomic<uint64_t>                     epoch{1};
+    mutable std::mutex                        mutex;
+    std::vector<std::unique_ptr<reader_slot>> readers;
+    std::vector<retired_object>               retired;
+  };
+
+  /**
+   * \brief \anchor qsbr-reader-brief registers the constructing thread as a
+   * reader of a \ref pc::qsbr_domain "qsbr_domain" for its lifetime.
+   *
+   * While registered, the thread must call quiescent() regularly, outside of
+   * any use of pointers protected by the domain. Around blocking calls, a
+   * reader can go offline() and online() again, so that it does not hold up
+   * reclamation while it sleeps.
+   */
+  class qsbr_reader {
+  public:
+    /// register with domain.
+    explicit qsbr_reader(qsbr_domain& domain = qsbr_domain::global());
+    qsbr_reader(const qsbr_reader&) = delete;
+    qsbr_reader& operator=(const qsbr_reader&) = delete;
+    /// destructor. Unregisters the reader.
+    ~qsbr_reader();
+
+    /// announce that the thread holds no protected pointers.
+    void quiescent() noexcept {
+      slot->epoch.store(domain.epoch.load(std::memory_order_seq_cst),
+                        std::memory_order_seq_cst);
+      // a reader coming online must not load a pointer retired by a writer
+      // which did not see its slot yet.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    /// stop holding up reclamation. The thread must not use protected
+    /// pointers until it calls online().
+    void offline() noexcept { slot->epoch.store(0, std::memory_order_release); }
+
+    /// undo offline().
+    void online() noexcept { quiescent(); }
+
+  private:
+    qsbr_domain&              domain;
+    qsbr_domain::reader_slot* slot;
+  };
+
+  /**
+   * \brief \anchor atomic-delegate-brief a delegate which can be rebound by
+   * one thread while others invoke it.
+   *
+   * The bound callable lives in a heap allocated delegate<Ret(Args...)>,
+   * which is published through an atomic pointer. Invoking loads the pointer
+   * with acquire semantics and calls the delegate, i.e. it costs one load more
+   * than invoking a delegate. bind() constructs a new delegate, publishes it
+   * and retires the old one to a \ref pc::qsbr_domain "qsbr_domain", which
+   * deletes it once all readers have passed a quiescent state.
+   *
+   * Threads invoking the atomic_delegate while it can be rebound must be
+   * registered readers of its domain, see \ref pc::qsbr_reader, and must not
+   * call quiescent() from within a bound callable. Rebinding is serialized by
+   * a mutex and allocates; it is meant for reconfiguration, not for the hot
+   * path.
+   *
+   * \tparam Ret return type of the delegate
+   * \tparam Args argument types of the delegate
+   */
+  template <typename Ret, typename... Args>
+  class atomic_delegate<Ret(Args...)> {
+  public:
+    /// delegate type holding the callable.
+    using delegate_t = ::pc::delegate<Ret(Args...)>;
+
+    /// construct an atomic_delegate with no callable bound.
+    explicit atomic_delegate(qsbr_domain& domain = qsbr_domain::global())
+        : current(new delegate_t()), domain(domain) {}
+    atomic_delegate(const atomic_delegate&) = delete;
+    atomic_delegate& operator=(const atomic_delegate&) = delete;
+    /// destructor. There must not be any concurrent invocations.
+    ~atomic_delegate() { delete current.load(std::memory_order_acquire); }
+
+    /// invoke the currently bound callable.
+    Ret operator()(impl::param_t<Args>... args) const {
+      return (*current.load(std::memory_order_acquire))(
+          std::forward<impl::param_t<Args>>(args)...);
+    }
+
+    /**
+     * \brief bind a new callable. Invocations which already loaded the old
+     * callable finish with it.
+     * \tparam BindArgs argument types, see the delegate_t constructors.
+     * \param bind_args arguments to construct the delegate from, i.e. a free
+     * function, an object and member function, a function object or a
+     * delegate.
+     */
+    template <typename... BindArgs>
+    void bind(BindArgs&&... bind_args);
+
+    /// unbind the callable.
+    void reset() { bind(delegate_t()); }
+
+    /// query if a callable is bound.
+    bool is_valid() const {
+      return current.load(std::memory_order_acquire)->is_valid();
+    }
+
+  private:
+    std::atomic<delegate_t*> current;
+    qsbr_domain&             domain;
+    std::mutex               writer_mutex;
+  };
+
+  inline qsbr_domain::~qsbr_domain() {
+    for (auto& r : retired)
+      r.deleter(r.object);
+  }
+
+  template <typename T>
+  void qsbr_domain::retire(T* object) {
+    std::lock_guard<std::mutex> lock(mutex);
+    // readers which announce the advanced epoch have loaded the pointer
+    // which replaced object, if any.
+    const uint64_t e = epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+    retired.push_back(
+        {object, [](void* p) { delete static_cast<T*>(p); }, e});
+    reclaim_locked();
+  }
+
+  inline size_t qsbr_domain::reclaim() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return reclaim_locked();
+  }
+
+  inline size_t qsbr_domain::num_retired() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return retired.size();
+  }
+
+  inline size_t qsbr_domain::reclaim_locked() {
+    uint64_t oldest = ~uint64_t{0};
+    for (auto& r : readers) {
+      const uint64_t e = r->epoch.load(std::memory_order_seq_cst);
+      if (e != 0 && e < oldest)
+        oldest = e;
+    }
+    size_t freed = 0;
+    for (size_t i = 0; i < retired.size();) {
+      if (retired[i].epoch <= oldest) {
+        retired[i].deleter(retired[i].object);
+        retired[i] = retired.back();
+        retired.pop_back();
+        ++freed;
+      } else {
+        ++i;
+      }
+    }
+    return freed;
+  }
+
+  inline qsbr_reader::qsbr_reader(qsbr_domain& domain) : domain(domain) {
+    std::lock_guard<std::mutex> lock(domain.mutex);
+    slot = nullptr;
+    for (auto& r : domain.readers) {
+      if (!r->used) {
+        slot = r.get();
+        break;
+      }
+    }
+    if (slot == nullptr) {
+      domain.readers.push_back(std::make_unique<qsbr_domain::reader_slot>());
+      slot = domain.readers.back().get();
+    }
+    slot->used = true;
+    // a new reader holds no pointers yet.
+    quiescent();
+  }
+
+  inline qsbr_reader::~qsbr_reader() {
+    std::lock_guard<std::mutex> lock(domain.mutex);
+    slot->epoch.store(0, std::memory_order_release);
+    slot->used = false;
+  }
+
+  template <typename Ret, typename... Args>
+  template <typename... BindArgs>
+  void atomic_delegate<Ret(Args...)>::bind(BindArgs&&... bind_args) {
+    // construct the delegate outside of the lock.
+    auto* next = new delegate_t(std::forward<BindArgs>(bind_args)...);
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    delegate_t* old = current.exchange(next, std::memory_order_seq_cst);
+    domain.retire(old);
+  }
+} // namespace pc
+
+#endif
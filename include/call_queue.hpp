@@ -0,0 +1,300 @@
+/**
+ * \file call_queue.hpp
+ * \author Pele Constam (pelectron1602\gmail.com)
+ * \brief This file defines the \ref pc::basic_call_queue<MultiProducer,
+ * SlotSize> class, a bounded lock-free queue of deferred calls, and its
+ * single and multi producer aliases.
+ * \version 0.1
+ * \date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef PC_CALL_QUEUE_HPP
+#define PC_CALL_QUEUE_HPP
+#include "delegate.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace pc {
+  namespace impl {
+    /// a callable and the arguments to call it with, stored in a call_queue
+    /// slot.
+    template <typename F, typename... Ts>
+    struct deferred_call {
+      F                 f;
+      std::tuple<Ts...> args;
+    };
+
+    /// calls and destroys the deferred_call T at storage. Only destroys it if
+    /// invoke is false.
+    template <typename T>
+    void run_deferred_call(void* storage, bool invoke) {
+      T* call = static_cast<T*>(storage);
+      // destroy the call even if invoking it throws.
+      struct destroy_guard {
+        T* call;
+        ~destroy_guard() { std::destroy_at(call); }
+      } guard{call};
+      if (invoke) {
+        std::apply(
+            [call](auto&... args) {
+              std::invoke(std::move(call->f), std::move(args)...);
+            },
+            call->args);
+      }
+    }
+
+    /// run function of a slot whose call could not be constructed.
+    inline void run_nothing(void*, bool) {}
+  } // namespace impl
+
+  /**
+   * \brief \anchor call-queue-brief a bounded, lock-free queue of deferred
+   * calls, i.e. callables together with the arguments to call them with.
+   *
+   * try_push() stores the callable and copies of the arguments in place in a
+   * slot of the queue. The consumer thread runs the calls in order with
+   * try_run_one() or drain(), which invoke the callable with the stored
+   * arguments and destroy both. Neither pushing nor running a call allocates;
+   * the slots are allocated once by the constructor. A call must fit into the
+   * storage of a slot, which is checked at compile time. With the default slot
+   * size of one cache line, this leaves 48 bytes for the callable and its
+   * arguments, e.g. a delegate and two pointers, or a lambda with six pointer
+   * sized captures.
+   *
+   * The queue is a ring buffer of slots with a sequence number each. A
+   * producer claims the slot at the tail, constructs the call in it and then
+   * publishes it by advancing the slot's sequence number. The consumer runs
+   * the call at the head once it is published and hands the slot back to the
+   * producers the same way. Producers and the consumer therefore only share
+   * the cache line of the slot they hand over.
+   *
+   * Only one thread at a time may consume. With MultiProducer = false, only
+   * one thread at a time may push as well, which saves the compare and swap
+   * on the tail. Use the \ref pc::spsc_call_queue and \ref pc::mpsc_call_queue
+   * aliases.
+   *
+   * The destructor destroys calls which have not been run without invoking
+   * them. A call_queue is neither copyable nor movable.
+   *
+   * \tparam MultiProducer true if multiple threads may push concurrently.
+   * \tparam SlotSize size of a slot in bytes, a multiple of the cache line
+   * size.
+   */
+  template <bool MultiProducer, size_t SlotSize = impl::cache_line_size>
+  class basic_call_queue {
+    static_assert(SlotSize % impl::cache_line_size == 0,
+                  "SlotSize must be a multiple of the cache line size.");
+
+    /// size of the sequence number and run function pointer of a slot.
+    static constexpr size_t slot_header_size = 16u;
+
+  public:
+    /// bytes available in a slot for a callable and its arguments.
+    static constexpr size_t storage_size = SlotSize - slot_header_size;
+
+    /**
+     * \brief construct a queue with at least capacity slots.
+     * \param capacity minimum number of calls the queue can hold. Rounded up
+     * to a power of two, at least 2.
+     */
+    explicit basic_call_queue(size_t capacity);
+    basic_call_queue(const basic_call_queue&) = delete;
+    basic_call_queue& operator=(const basic_call_queue&) = delete;
+
+    /// destructor. Destroys the calls which have not been run.
+    ~basic_call_queue();
+
+    /**
+     * \brief push a call to f with args. f and args are decay copied into a
+     * slot.
+     * \param f callable, e.g. a delegate or a lambda.
+     * \param args arguments f is called with when the call is run.
+     * \return true the call was pushed
+     * \return false the queue is full
+     */
+    template <typename F, typename... CallArgs>
+    bool try_push(F&& f, CallArgs&&... args);
+
+    /**
+     * \brief run the oldest call. Must only be called by the consumer thread.
+     * \return true a call was run
+     * \return false the queue is empty
+     */
+    bool try_run_one();
+
+    /**
+     * \brief run pending calls until the queue is empty or max_calls have
+     * been run. Must only be called by the consumer thread.
+     * \param max_calls maximum number of calls to run
+     * \return the number of calls run
+     */
+    size_t drain(size_t max_calls = static_cast<size_t>(-1));
+
+    /// checks if there is no call to run. Must only be called by the consumer
+    /// thread.
+    bool empty() const;
+
+    /// get the number of slots.
+    size_t capacity() const;
+
+  private:
+    /// a slot of the ring buffer. A slot at position pos can be pushed to if
+    /// its sequence is pos, and run if its sequence is pos + 1.
+    struct alignas(impl::cache_line_size) slot {
+      std::atomic<size_t> sequence;
+      void (*run)(void* storage, bool invoke);
+      alignas(slot_header_size) unsigned char storage[storage_size];
+    };
+    static_assert(sizeof(slot) == SlotSize,
+                  "Something wrong in the implementation. A slot is not "
+                  "SlotSize bytes big.");
+
+    /// rounds n up to a power of two, at least 2. With a single slot, a
+    /// published call could not be told apart from a free slot.
+    static size_t round_up_capacity(size_t n);
+
+    const size_t            mask;
+    std::unique_ptr<slot[]> slots;
+    alignas(impl::cache_line_size) std::atomic<size_t> tail{0}; //< producers
+    alignas(impl::cache_line_size) size_t head{0};              //< consumer
+  };
+
+  /// single producer, single consumer call queue.
+  using spsc_call_queue = basic_call_queue<false>;
+  /// multi producer, single consumer call queue.
+  using mpsc_call_queue = basic_call_queue<true>;
+
+  template <bool MultiProducer, size_t SlotSize>
+  basic_call_queue<MultiProducer, SlotSize>::basic_call_queue(size_t capacity)
+      : mask(round_up_capacity(capacity) - 1),
+        slots(new slot[mask + 1]) {
+    for (size_t i = 0; i <= mask; ++i) {
+      slots[i].sequence.store(i, std::memory_order_relaxed);
+      slots[i].run = &impl::run_nothing;
+    }
+  }
+
+  template <bool MultiProducer, size_t SlotSize>
+  basic_call_queue<MultiProducer, SlotSize>::~basic_call_queue() {
+    while (!empty()) {
+      slot& s = slots[head & mask];
+      s.run(s.storage, false);
+      ++head;
+    }
+  }
+
+  template <bool MultiProducer, size_t SlotSize>
+  template <typename F, typename... CallArgs>
+  bool basic_call_queue<MultiProducer, SlotSize>::try_push(
+      F&& f, CallArgs&&... args) {
+    using call_t =
+        impl::deferred_call<std::decay_t<F>, std::decay_t<CallArgs>...>;
+    static_assert(std::is_invocable_v<std::decay_t<F>,
+                                      std::decay_t<CallArgs>...>,
+                  "f must be invocable with args.");
+    static_assert(sizeof(call_t) <= storage_size,
+                  "the callable and its arguments do not fit into a slot. "
+                  "Use a bigger SlotSize.");
+    static_assert(alignof(call_t) <= slot_header_size,
+                  "the callable or an argument is over aligned.");
+
+    size_t pos = tail.load(std::memory_order_relaxed);
+    slot*  s;
+    while (true) {
+      s = &slots[pos & mask];
+      const size_t seq = s->sequence.load(std::memory_order_acquire);
+      const auto   diff =
+          static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+      if (diff == 0) {
+        if constexpr (MultiProducer) {
+          if (tail.compare_exchange_weak(pos, pos + 1,
+                                         std::memory_order_relaxed))
+            break;
+        } else {
+          tail.store(pos + 1, std::memory_order_relaxed);
+          break;
+        }
+      } else if (diff < 0) {
+        // the consumer has not run the call a full lap ago yet.
+        return false;
+      } else {
+        pos = tail.load(std::memory_order_relaxed);
+      }
+    }
+    // the slot is claimed now. It is published even if copying f or args
+    // throws, with a run function that does nothing, so the consumer is not
+    // stuck at it.
+    struct publish_guard {
+      slot*  s;
+      size_t pos;
+      ~publish_guard() { s->sequence.store(pos + 1, std::memory_order_release); }
+    } guard{s, pos};
+    s->run = &impl::run_nothing;
+    ::new (static_cast<void*>(s->storage))
+        call_t{std::forward<F>(f),
+               std::tuple<std::decay_t<CallArgs>...>(
+                   std::forward<CallArgs>(args)...)};
+    s->run = &impl::run_deferred_call<call_t>;
+    return true;
+  }
+
+  template <bool MultiProducer, size_t SlotSize>
+  bool basic_call_queue<MultiProducer, SlotSize>::try_run_one() {
+    if (empty())
+      return false;
+    // head is advanced before running the call, so the call may run further
+    // calls of this queue itself.
+    const size_t pos = head++;
+    slot&        s = slots[pos & mask];
+    struct release_guard {
+      slot*  s;
+      size_t next_lap;
+      ~release_guard() {
+        s->sequence.store(next_lap, std::memory_order_release);
+      }
+    } guard{&s, pos + mask + 1};
+    s.run(s.storage, true);
+    return true;
+  }
+
+  template <bool MultiProducer, size_t SlotSize>
+  size_t basic_call_queue<MultiProducer, SlotSize>::drain(size_t max_calls) {
+    size_t n = 0;
+    while (n < max_calls && try_run_one())
+      ++n;
+    return n;
+  }
+
+  template <bool MultiProducer, size_t SlotSize>
+  bool basic_call_queue<MultiProducer, SlotSize>::empty() const {
+    return slots[head & mask].sequence.load(std::memory_order_acquire) !=
+           head + 1;
+  }
+
+  template <bool MultiProducer, size_t SlotSize>
+  size_t basic_call_queue<MultiProducer, SlotSize>::capacity() const {
+    return mask + 1;
+  }
+
+  template <bool MultiProducer, size_t SlotSize>
+  size_t basic_call_queue<MultiProducer, SlotSize>::round_up_capacity(
+      size_t n) {
+    size_t capacity = 2;
+    while (capacity < n)
+      capacity *= 2;
+    return capacity;
+  }
+} // namespace pc
+
+#endif
@@ -0,0 +1,245 @@
+/**
+ * \file compose.hpp
+ * \author Pele Constam (pelectron1602\gmail.com)
+ * \brief This file defines \ref pc::pipeline, which fuses a sequence of
+ * processing stages into one function object, and \ref pc::compose. It also
+ * defines delegate::then(), delegate::map() and delegate::filter().
+ * \version 0.1
+ * \date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef PC_COMPOSE_HPP
+#define PC_COMPOSE_HPP
+#include "delegate.hpp"
+
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace pc {
+  namespace impl {
+    /// stage which is invoked with the previous result, or with the
+    /// arguments if there is none.
+    struct then_tag {};
+    /// stage which transforms the previous result.
+    struct map_tag {};
+    /// stage which decides if the following stages run.
+    struct filter_tag {};
+
+    /**
+     * \brief a stage of a pipeline. Empty callables, e.g. lambdas without
+     * captures, are stored as base class, so that they take no space.
+     * \tparam Tag one of then_tag, map_tag and filter_tag
+     * \tparam F callable type
+     */
+    template <typename Tag, typename F,
+              bool Empty = std::is_empty_v<F> && !std::is_final_v<F>>
+    struct stage : private F {
+      using tag = Tag;
+      explicit stage(F f) : F(std::move(f)) {}
+      F& get() { return *this; }
+    };
+
+    /// specialization for callables with state.
+    template <typename Tag, typename F>
+    struct stage<Tag, F, false> {
+      using tag = Tag;
+      explicit stage(F f) : f(std::move(f)) {}
+      F& get() { return f; }
+      F  f;
+    };
+  } // namespace impl
+
+  /**
+   * \brief \anchor pipeline-brief a function object calling a sequence of
+   * stages, where each stage gets the result of the previous one.
+   *
+   * The first stage is called with the pipeline's arguments. Every following
+   * stage is called with the result of the previous stage, or with the
+   * pipeline's arguments again if that returned void. A filter stage is a
+   * predicate: if it returns false, the following stages are skipped and the
+   * pipeline returns a value initialized result, like an invalid delegate.
+   * Otherwise, the value it was called with flows on unchanged.
+   *
+   * All stages are known at compile time and called directly, so the
+   * compiler can inline the whole pipeline into one function. Bound to a
+   * delegate, it costs a single indirect call. Stages without state take no
+   * space, so a pipeline of lambdas without captures and std::ref()s of
+   * delegates usually fits into the delegate's inline storage; to fit larger
+   * ones, define PC_DELEGATE_MAX_STORAGE_SIZE, see
+   * [max_storage_size](#max_storage_size).
+   *
+   * Pipelines are built with \ref pc::compose or with delegate::then(),
+   * delegate::map() and delegate::filter(), and extended with then(), map()
+   * and filter(), each of which returns a new pipeline.
+   * \tparam Stages the stages, impl::stage<Tag, F>
+   */
+  template <typename... Stages>
+  class pipeline {
+  public:
+    /// construct from the stages.
+    explicit pipeline(std::tuple<Stages...> stages)
+        : stages(std::move(stages)) {}
+
+    /**
+     * \brief call the stages in sequence.
+     * \param args arguments of the first stage
+     * \return the result of the last stage
+     */
+    template <typename... Ts,
+              std::enable_if_t<std::is_invocable_v<
+                  decltype(std::declval<std::tuple_element_t<
+                               0, std::tuple<Stages...>>&>()
+                               .get()),
+                  Ts...>>* = nullptr>
+    auto operator()(Ts&&... args) {
+      auto arg_tuple = std::forward_as_tuple(std::forward<Ts>(args)...);
+      return run<0>(arg_tuple);
+    }
+
+    /// append a stage called with the result of the last one.
+    template <typename F>
+    auto then(F&& f) && {
+      return append<impl::then_tag>(std::forward<F>(f));
+    }
+
+    /// append a stage transforming the result of the last one.
+    template <typename F>
+    auto map(F&& f) && {
+      return append<impl::map_tag>(std::forward<F>(f));
+    }
+
+    /// append a predicate deciding if the following stages run.
+    template <typename P>
+    auto filter(P&& p) && {
+      return append<impl::filter_tag>(std::forward<P>(p));
+    }
+
+    /// \copydoc then()
+    template <typename F>
+    auto then(F&& f) const& {
+      return pipeline(*this).then(std::forward<F>(f));
+    }
+
+    /// \copydoc map()
+    template <typename F>
+    auto map(F&& f) const& {
+      return pipeline(*this).map(std::forward<F>(f));
+    }
+
+    /// \copydoc filter()
+    template <typename P>
+    auto filter(P&& p) const& {
+      return pipeline(*this).filter(std::forward<P>(p));
+    }
+
+  private:
+    template <typename... Other>
+    friend class pipeline;
+
+    /// move the stages into a pipeline with one more stage.
+    template <typename Tag, typename F>
+    auto append(F&& f) {
+      using next_t = impl::stage<Tag, std::decay_t<F>>;
+      return pipeline<Stages..., next_t>(std::tuple_cat(
+          std::move(stages),
+          std::tuple<next_t>(next_t(std::forward<F>(f)))));
+    }
+
+    /// call stage I with the previous result, or with the arguments if there
+    /// is none, and the following stages with its result.
+    template <size_t I, typename ArgTuple, typename... V>
+    auto run(ArgTuple& args, V&&... value) {
+      if constexpr (I == sizeof...(Stages)) {
+        if constexpr (sizeof...(V) == 1)
+          return (std::forward<V>(value), ...);
+        else
+          return;
+      } else {
+        using tag =
+            typename std::tuple_element_t<I, std::tuple<Stages...>>::tag;
+        auto& f = std::get<I>(stages).get();
+        if constexpr (std::is_same_v<tag, impl::filter_tag>) {
+          using result_t =
+              decltype(run<I + 1>(args, std::forward<V>(value)...));
+          // the predicate only gets to look at the value.
+          bool accepted;
+          if constexpr (sizeof...(V) == 1)
+            accepted = std::invoke(f, std::as_const(value)...);
+          else
+            accepted = std::apply(f, args);
+          if (!accepted) {
+            if constexpr (std::is_void_v<result_t>)
+              return;
+            else
+              return result_t{};
+          }
+          return run<I + 1>(args, std::forward<V>(value)...);
+        } else {
+          static_assert(!std::is_same_v<tag, impl::map_tag> ||
+                            sizeof...(V) == 1,
+                        "map() needs a previous stage which returns a value");
+          if constexpr (sizeof...(V) == 1) {
+            using result_t = std::invoke_result_t<decltype(f), V&&...>;
+            if constexpr (std::is_void_v<result_t>) {
+              std::invoke(f, std::forward<V>(value)...);
+              return run<I + 1>(args);
+            } else {
+              return run<I + 1>(args,
+                                std::invoke(f, std::forward<V>(value)...));
+            }
+          } else {
+            using result_t = decltype(std::apply(f, args));
+            if constexpr (std::is_void_v<result_t>) {
+              std::apply(f, args);
+              return run<I + 1>(args);
+            } else {
+              return run<I + 1>(args, std::apply(f, args));
+            }
+          }
+        }
+      }
+    }
+
+    std::tuple<Stages...> stages;
+  };
+
+  /**
+   * \brief start a pipeline with a first stage.
+   * \tparam F callable type. Use std::ref() to reference a delegate instead
+   * of copying it.
+   * \param f the first stage, called with the pipeline's arguments
+   * \return pipeline with one stage
+   */
+  template <typename F>
+  auto compose(F&& f) {
+    using stage_t = impl::stage<impl::then_tag, std::decay_t<F>>;
+    return pipeline<stage_t>(std::tuple<stage_t>(stage_t(std::forward<F>(f))));
+  }
+
+  template <typename Ret, typename... Args>
+  template <typename F>
+  auto delegate<Ret(Args...)>::then(F&& f) {
+    return compose(std::ref(*this)).then(std::forward<F>(f));
+  }
+
+  template <typename Ret, typename... Args>
+  template <typename F>
+  auto delegate<Ret(Args...)>::map(F&& f) {
+    static_assert(!std::is_void_v<Ret>, "cannot map the result void");
+    return compose(std::ref(*this)).map(std::forward<F>(f));
+  }
+
+  template <typename Ret, typename... Args>
+  template <typename P>
+  auto delegate<Ret(Args...)>::filter(P&& p) {
+    return compose(std::ref(*this)).filter(std::forward<P>(p));
+  }
+} // namespace pc
+
+#endif
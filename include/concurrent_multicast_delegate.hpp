@@ -0,0 +1,322 @@
+/**
+ * \file concurrent_multicast_delegate.hpp
+ * \author Pele Constam (pelectron1602\gmail.com)
+ * \brief This file defines the \ref
+ * pc::concurrent_multicast_delegate<Ret(Args...)> class, a multicast delegate
+ * which can be invoked from many threads while others bind and unbind
+ * callables.
+ * \version 0.1
+ * \date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef PC_CONCURRENT_MULTICAST_DELEGATE_HPP
+#define PC_CONCURRENT_MULTICAST_DELEGATE_HPP
+#include "delegate.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pc {
+#ifndef GENERATING_DOCUMENTATION
+  /// forward declaration, intentionally left unimplemented.
+  template <typename>
+  class concurrent_multicast_delegate;
+#endif
+
+  namespace impl {
+    /// number of reader slots of a rcu_domain. Threads are spread over the
+    /// slots, threads sharing a slot stay correct but share a cache line.
+    static constexpr size_t rcu_reader_slots = 32u;
+
+    /**
+     * \brief minimal read-copy-update domain.
+     *
+     * Readers announce themselves by incrementing a counter in their reader
+     * slot before loading a shared pointer, and decrement it when they are
+     * done. Each slot has two counters, selected by the parity of the
+     * domain's epoch. A writer publishes a new pointer first and then calls
+     * synchronize(), which flips the epoch twice and waits for the counters of
+     * the old parity to drain each time. Afterwards no reader can still hold
+     * the old pointer, and it can be freed.
+     *
+     * Readers never block and never write to a cache line shared with other
+     * slots. Writers block until all readers which started before the update
+     * are finished, so a reader must never call synchronize() on its own
+     * domain.
+     */
+    class rcu_domain {
+    public:
+      rcu_domain() = default;
+      rcu_domain(const rcu_domain&) = delete;
+      rcu_domain& operator=(const rcu_domain&) = delete;
+
+      /// enter a read side critical section.
+      /// \return token to pass to read_unlock().
+      size_t read_lock() noexcept {
+        const size_t slot = this_thread_slot();
+        const size_t parity = epoch.load(std::memory_order_seq_cst) & 1u;
+        slots[slot].count[parity].fetch_add(1, std::memory_order_seq_cst);
+        return slot * 2 + parity;
+      }
+
+      /// leave a read side critical section.
+      /// \param token token returned by the matching read_lock().
+      void read_unlock(size_t token) noexcept {
+        slots[token / 2].count[token % 2].fetch_sub(1,
+                                                    std::memory_order_release);
+      }
+
+      /// wait until all read side critical sections which started before the
+      /// call have finished.
+      void synchronize() noexcept {
+        for (int phase = 0; phase < 2; ++phase) {
+          const size_t old_parity =
+              epoch.fetch_add(1, std::memory_order_seq_cst) & 1u;
+          for (auto& slot : slots) {
+            while (slot.count[old_parity].load(std::memory_order_seq_cst) !=
+                   0) {
+              std::this_thread::yield();
+            }
+          }
+        }
+      }
+
+    private:
+      /// reader counters of one slot, on their own cache line.
+      struct alignas(cache_line_size) reader_slot {
+        std::atomic<size_t> count[2]{};
+      };
+
+      /// assigns each thread a slot on first use.
+      static size_t this_thread_slot() noexcept {
+        static std::atomic<size_t> next_slot{0};
+        thread_local const size_t slot =
+            next_slot.fetch_add(1, std::memory_order_relaxed) %
+            rcu_reader_slots;
+        return slot;
+      }
+
+      reader_slot         slots[rcu_reader_slots];
+      std::atomic<size_t> epoch{0};
+    };
+
+    /// a read side critical section of a rcu_domain for its lifetime. Leaves
+    /// it even if a callable throws, which would otherwise block every
+    /// writer for good.
+    struct rcu_read_guard {
+      explicit rcu_read_guard(rcu_domain& d)
+          : domain(d), token(d.read_lock()) {}
+      ~rcu_read_guard() { domain.read_unlock(token); }
+      rcu_read_guard(const rcu_read_guard&) = delete;
+      rcu_read_guard& operator=(const rcu_read_guard&) = delete;
+
+      rcu_domain&  domain;
+      const size_t token;
+    };
+  } // namespace impl
+
+  /**
+   * \brief \anchor concurrent-multicast-delegate-brief a multicast delegate
+   * which can be invoked concurrently from any number of threads while other
+   * threads bind and unbind callables.
+   *
+   * The bound callables live in an immutable snapshot, i.e. a vector of
+   * delegate<Ret(Args...)>. Invoking the concurrent_multicast_delegate loads
+   * the current snapshot and calls each delegate in it. This takes no lock;
+   * the snapshot is protected by a \ref pc::impl::rcu_domain "rcu_domain"
+   * instead. bind(), unbind() and reset() copy the current snapshot, modify the
+   * copy, atomically publish it and free the old snapshot once no invocation
+   * can still be using it. Modifications are serialized by a mutex and are
+   * therefore considerably more expensive than invocations.
+   *
+   * Unlike multicast_delegate, this class does not collect the returned values,
+   * since there is no sensible shared results vector for concurrent callers.
+   * Use invoke_into() to receive the returned values of one invocation.
+   *
+   * \note A callable must not bind, unbind or reset the
+   * concurrent_multicast_delegate it is invoked from. This would wait for its
+   * own invocation to finish and never return.
+   * \note Concurrently invoked callables are invoked concurrently. Function
+   * objects with mutable state must synchronize themselves.
+   *
+   * \tparam Ret return type of the delegate
+   * \tparam Args argument types of the delegate
+   */
+  template <typename Ret, typename... Args>
+  class concurrent_multicast_delegate<Ret(Args...)> {
+  public:
+    /// single delegate type.
+    using delegate_t = ::pc::delegate<Ret(Args...)>;
+    /// identifies a bound callable. Returned by bind().
+    using subscription_id = size_t;
+
+    /// default constructor. No callables are bound.
+    concurrent_multicast_delegate();
+    concurrent_multicast_delegate(const concurrent_multicast_delegate&) =
+        delete;
+    concurrent_multicast_delegate&
+        operator=(const concurrent_multicast_delegate&) = delete;
+    /// destructor. There must not be any concurrent invocations.
+    ~concurrent_multicast_delegate();
+
+    /// invoke all bound callables. Returned values are discarded.
+    void operator()(Args... args);
+
+    /**
+     * \brief invoke all bound callables and write the returned values to out.
+     * \tparam OutputIt output iterator type
+     * \param out output iterator receiving one value per callable
+     * \param args arguments
+     * \return OutputIt iterator past the last written value
+     */
+    template <typename OutputIt>
+    OutputIt invoke_into(OutputIt out, Args... args);
+
+    /// get the number of callables bound.
+    size_t num_callables() const;
+
+    /**
+     * \brief bind a callable.
+     * \tparam BindArgs argument types, see the delegate_t constructors.
+     * \param bind_args arguments to construct the delegate from, i.e. a free
+     * function, an object and member function, a function object or a
+     * delegate.
+     * \return subscription_id id to pass to unbind()
+     */
+    template <typename... BindArgs>
+    subscription_id bind(BindArgs&&... bind_args);
+
+    /**
+     * \brief unbind a callable.
+     * \param id id returned by bind()
+     * \return true the callable was unbound
+     * \return false no callable with this id is bound
+     */
+    bool unbind(subscription_id id);
+
+    /// unbind all callables.
+    void reset();
+
+  private:
+    /// immutable list of bound callables.
+    struct snapshot {
+      std::vector<delegate_t>      delegates;
+      std::vector<subscription_id> ids; //< parallel to delegates
+    };
+
+    /// copy the current snapshot, apply modify to the copy and publish it.
+    /// \return the value returned by modify
+    template <typename F>
+    bool update(F&& modify);
+
+    std::atomic<snapshot*> current;
+    mutable impl::rcu_domain domain;
+    std::mutex               writer_mutex;
+    subscription_id          next_id{0};
+  };
+
+  template <typename Ret, typename... Args>
+  concurrent_multicast_delegate<Ret(Args...)>::concurrent_multicast_delegate()
+      : current(new snapshot{}) {}
+
+  template <typename Ret, typename... Args>
+  concurrent_multicast_delegate<
+      Ret(Args...)>::~concurrent_multicast_delegate() {
+    delete current.load(std::memory_order_acquire);
+  }
+
+  template <typename Ret, typename... Args>
+  void concurrent_multicast_delegate<Ret(Args...)>::operator()(Args... args) {
+    impl::rcu_read_guard guard(domain);
+    snapshot*            snap = current.load(std::memory_order_seq_cst);
+    for (auto& del : snap->delegates) {
+      del(args...);
+    }
+  }
+
+  template <typename Ret, typename... Args>
+  template <typename OutputIt>
+  OutputIt concurrent_multicast_delegate<Ret(Args...)>::invoke_into(
+      OutputIt out, Args... args) {
+    static_assert(!std::is_same_v<Ret, void>,
+                  "Cannot call this function with Ret = void.");
+    impl::rcu_read_guard guard(domain);
+    snapshot*            snap = current.load(std::memory_order_seq_cst);
+    for (auto& del : snap->delegates) {
+      *out = del(args...);
+      ++out;
+    }
+    return out;
+  }
+
+  template <typename Ret, typename... Args>
+  size_t concurrent_multicast_delegate<Ret(Args...)>::num_callables() const {
+    impl::rcu_read_guard guard(domain);
+    return current.load(std::memory_order_seq_cst)->delegates.size();
+  }
+
+  template <typename Ret, typename... Args>
+  template <typename... BindArgs>
+  typename concurrent_multicast_delegate<Ret(Args...)>::subscription_id
+      concurrent_multicast_delegate<Ret(Args...)>::bind(
+          BindArgs&&... bind_args) {
+    // construct the delegate outside of the lock.
+    delegate_t      d(std::forward<BindArgs>(bind_args)...);
+    subscription_id id{0};
+    update([&](snapshot& next) {
+      id = next_id++;
+      next.delegates.push_back(std::move(d));
+      next.ids.push_back(id);
+      return true;
+    });
+    return id;
+  }
+
+  template <typename Ret, typename... Args>
+  bool concurrent_multicast_delegate<Ret(Args...)>::unbind(subscription_id id) {
+    return update([id](snapshot& next) {
+      for (size_t i = 0; i < next.ids.size(); ++i) {
+        if (next.ids[i] == id) {
+          next.ids.erase(next.ids.begin() + i);
+          next.delegates.erase(next.delegates.begin() + i);
+          return true;
+        }
+      }
+      return false;
+    });
+  }
+
+  template <typename Ret, typename... Args>
+  void concurrent_multicast_delegate<Ret(Args...)>::reset() {
+    update([](snapshot& next) {
+      next.delegates.clear();
+      next.ids.clear();
+      return true;
+    });
+  }
+
+  template <typename Ret, typename... Args>
+  template <typename F>
+  bool concurrent_multicast_delegate<Ret(Args...)>::update(F&& modify) {
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    snapshot* old = current.load(std::memory_order_relaxed);
+    snapshot* next = new snapshot(*old);
+    if (!modify(*next)) {
+      delete next;
+      return false;
+    }
+    current.store(next, std::memory_order_seq_cst);
+    // wait until no invocation can still be iterating over old.
+    domain.synchronize();
+    delete old;
+    return true;
+  }
+} // namespace pc
+
+#endif
@@ -0,0 +1,506 @@
+/**
+ * \file coroutine.hpp
+ * \author Pele Constam (pelectron1602\gmail.com)
+ * \brief This file defines the C++20 coroutine support: \ref pc::task<T>, an
+ * awaitable coroutine return type which can be used as the return type of
+ * delegates, \ref pc::when_all() for tasks, multicast_delegate::emit_async(),
+ * and the pools coroutine frames can be allocated from.
+ *
+ * Everything in this file is only defined if the compiler supports coroutines,
+ * in which case PC_HAS_COROUTINES is defined. Otherwise, including this file
+ * has no effect, i.e. it can be included from C++17 code.
+ * \version 0.1
+ * \date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef PC_COROUTINE_HPP
+#define PC_COROUTINE_HPP
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define PC_HAS_COROUTINES 1
+#endif
+#endif
+
+#ifdef PC_HAS_COROUTINES
+#include "multicast_delegate.hpp"
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace pc {
+  template <typename T = void>
+  class task;
+
+  namespace impl {
+    /// a type erased frame pool, see \ref pc::frame_pool_scope.
+    struct frame_resource {
+      void* pool{nullptr};
+      void* (*allocate)(void* pool, size_t size){nullptr};
+      void (*deallocate)(void* pool, void* p, size_t size){nullptr};
+
+      /// the pool new frames of this thread are allocated from. nullptr
+      /// means global operator new.
+      static frame_resource*& current() {
+        thread_local frame_resource* r = nullptr;
+        return r;
+      }
+    };
+
+    /**
+     * \brief the part of a task's promise which does not depend on the value
+     * type.
+     *
+     * Frames are allocated from the current thread's \ref pc::frame_pool_scope,
+     * if any. The resource a frame was allocated from is stored behind the
+     * frame, so frames can be destroyed on any thread.
+     *
+     * Tasks are lazy: the body runs once the task is awaited or started by a
+     * task_group. When the body has finished, control passes through
+     * symmetric transfer to the awaiting coroutine, or to the coroutine
+     * returned by on_done.
+     */
+    struct task_promise_base {
+      /// allocate a frame.
+      static void* operator new(size_t size) {
+        frame_resource* r = frame_resource::current();
+        const size_t    total = trailer_offset(size) + sizeof(frame_resource);
+        void*           frame =
+            r != nullptr ? r->allocate(r->pool, total) : ::operator new(total);
+        new (static_cast<char*>(frame) + trailer_offset(size))
+            frame_resource(r != nullptr ? *r : frame_resource{});
+        return frame;
+      }
+
+      /// free a frame to the resource it was allocated from.
+      static void operator delete(void* frame, size_t size) {
+        const frame_resource r =
+            *std::launder(reinterpret_cast<frame_resource*>(
+                static_cast<char*>(frame) + trailer_offset(size)));
+        if (r.deallocate != nullptr)
+          r.deallocate(r.pool, frame,
+                       trailer_offset(size) + sizeof(frame_resource));
+        else
+          ::operator delete(frame);
+      }
+
+      /// awaiter of final_suspend().
+      struct final_awaiter {
+        bool await_ready() noexcept { return false; }
+        template <typename Promise>
+        std::coroutine_handle<>
+            await_suspend(std::coroutine_handle<Promise> h) noexcept {
+          auto& p = h.promise();
+          if (p.continuation)
+            return p.continuation;
+          // on_done may destroy this frame, so copy what is needed first.
+          auto* on_done = p.on_done;
+          void* context = p.on_done_context;
+          if (on_done != nullptr)
+            return on_done(context);
+          return std::noop_coroutine();
+        }
+        void await_resume() noexcept {}
+      };
+
+      std::suspend_always initial_suspend() noexcept { return {}; }
+      final_awaiter       final_suspend() noexcept { return {}; }
+      void unhandled_exception() { exception = std::current_exception(); }
+
+      std::coroutine_handle<> continuation; //< resumed once the body is done
+      /// called instead, if set. Returns the coroutine to resume next.
+      std::coroutine_handle<> (*on_done)(void*){nullptr};
+      void*                   on_done_context{nullptr};
+      std::exception_ptr      exception;
+
+    private:
+      static constexpr size_t trailer_offset(size_t size) {
+        constexpr size_t a = alignof(frame_resource);
+        return (size + a - 1) / a * a;
+      }
+    };
+
+    /// the promise type of task<T>.
+    template <typename T>
+    struct task_promise : task_promise_base {
+      task<T> get_return_object() noexcept;
+
+      template <typename U>
+      void return_value(U&& v) {
+        value.emplace(std::forward<U>(v));
+      }
+
+      /// rethrow the exception thrown by the body, or move out the value.
+      T result() {
+        if (exception)
+          std::rethrow_exception(exception);
+        return std::move(*value);
+      }
+
+      std::optional<T> value;
+    };
+
+    /// specialization for T = void.
+    template <>
+    struct task_promise<void> : task_promise_base {
+      task<void> get_return_object() noexcept;
+
+      void return_void() noexcept {}
+
+      /// rethrow the exception thrown by the body, if any.
+      void result() {
+        if (exception)
+          std::rethrow_exception(exception);
+      }
+    };
+
+    /// meta function for the value type of a task.
+    template <typename Task>
+    struct task_value;
+
+    /// specialization for task<T>.
+    template <typename T>
+    struct task_value<task<T>> {
+      /// result of meta function
+      using type = T;
+    };
+
+    /// get the value type of a task.
+    template <typename Task>
+    using task_value_t = typename task_value<Task>::type;
+
+    /**
+     * \brief awaits a number of tasks, which are started when the task_group
+     * is awaited. Resumes the awaiting coroutine once all of them are done,
+     * on the thread which finishes the last one.
+     * \tparam T value type of the tasks.
+     */
+    template <typename T>
+    class task_group {
+    public:
+      task_group() = default;
+      /// construct from tasks to await.
+      explicit task_group(std::vector<task<T>> tasks)
+          : tasks(std::move(tasks)) {}
+      task_group(task_group&& other) noexcept : tasks(std::move(other.tasks)) {}
+
+      bool await_ready() const noexcept { return tasks.empty(); }
+
+      bool await_suspend(std::coroutine_handle<> h) {
+        start_all(h);
+        return !count_down();
+      }
+
+      /// get the values of the tasks, or rethrow the first exception thrown.
+      /// \return std::vector<T> the values in the order of the tasks, or void
+      /// for T = void.
+      auto await_resume();
+
+    protected:
+      /// start all tasks. Must be followed by count_down(), which drops the
+      /// extra count held while starting.
+      void start_all(std::coroutine_handle<> h);
+
+      /// \return true if this was the last count, i.e. all tasks are done.
+      bool count_down() {
+        return remaining.fetch_sub(1, std::memory_order_acq_rel) == 1;
+      }
+
+      std::vector<task<T>> tasks;
+
+    private:
+      /// count a task as done. \return the waiter if it was the last one,
+      /// or std::noop_coroutine().
+      static std::coroutine_handle<> task_done(void* self);
+
+      std::atomic<size_t>     remaining{0};
+      std::coroutine_handle<> waiter;
+    };
+  } // namespace impl
+
+  /**
+   * \brief \anchor task-brief a lazily started coroutine, which can be
+   * co_awaited exactly once.
+   *
+   * task<T> is the intended return type of coroutines bound to a delegate,
+   * e.g. a `pc::delegate<pc::task<int>(int)>` bound to a lambda whose body
+   * uses co_await. The task owns the coroutine frame, i.e. nothing has to be
+   * cleaned up by hand. Frames are allocated from the pool of the
+   * \ref pc::frame_pool_scope active on the thread calling the coroutine.
+   *
+   * Awaiting an invalid task, e.g. one returned by an empty delegate, does not
+   * suspend and results in a value initialized T.
+   * \tparam T value type, must be void or an object type.
+   */
+  template <typename T>
+  class task {
+  public:
+    /// promise type used by the compiler.
+    using promise_type = impl::task_promise<T>;
+    /// value type.
+    using value_type = T;
+
+    /// default constructor. Creates an invalid task.
+    task() = default;
+    /// construct from the coroutine handle.
+    explicit task(std::coroutine_handle<promise_type> h) : handle(h) {}
+    task(const task&) = delete;
+    task& operator=(const task&) = delete;
+    /// move constructor
+    task(task&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+    /// move assignment operator
+    task& operator=(task&& other) noexcept {
+      std::swap(handle, other.handle);
+      return *this;
+    }
+    /// destructor. Destroys the coroutine frame.
+    ~task() {
+      if (handle)
+        handle.destroy();
+    }
+
+    /// checks if the task refers to a coroutine.
+    bool valid() const noexcept { return static_cast<bool>(handle); }
+
+    /// awaiter of a task.
+    struct awaiter {
+      bool await_ready() const noexcept { return !handle; }
+      std::coroutine_handle<>
+          await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+      }
+      T await_resume() {
+        if (!handle) {
+          if constexpr (!std::is_void_v<T>)
+            return T{};
+          else
+            return;
+        }
+        return handle.promise().result();
+      }
+      std::coroutine_handle<promise_type> handle;
+    };
+
+    /// await the task. Starts it, and resumes the awaiting coroutine with the
+    /// value once it is done.
+    awaiter operator co_await() && noexcept { return awaiter{handle}; }
+    /// \copydoc operator co_await()&&
+    awaiter operator co_await() & noexcept { return awaiter{handle}; }
+
+  private:
+    template <typename>
+    friend class impl::task_group;
+
+    std::coroutine_handle<promise_type> handle;
+  };
+
+  /**
+   * \brief await a number of tasks, which are started one after the other on
+   * the awaiting thread and run until their first suspension. The awaiting
+   * coroutine is resumed once all of them are done.
+   * \param tasks the tasks to await
+   * \return awaitable resulting in a std::vector<T> of the values, in the
+   * order of tasks, or void for T = void.
+   */
+  template <typename T>
+  impl::task_group<T> when_all(std::vector<task<T>> tasks) {
+    return impl::task_group<T>(std::move(tasks));
+  }
+
+  /**
+   * \brief a pool of coroutine frames, which keeps freed frames in free lists
+   * per size class instead of returning them to global operator delete.
+   * Frames bigger than max_frame_size are not pooled. Thread safe.
+   */
+  class frame_pool {
+  public:
+    /// size classes are multiples of this.
+    static constexpr size_t granularity = 64;
+
+    /// construct with the biggest frame size to pool.
+    explicit frame_pool(size_t max_frame_size = 1024)
+        : free((max_frame_size + granularity - 1) / granularity) {}
+    frame_pool(const frame_pool&) = delete;
+    frame_pool& operator=(const frame_pool&) = delete;
+    /// destructor. Frees the pooled frames; frames in use must have been
+    /// deallocated before.
+    ~frame_pool() {
+      for (auto& list : free) {
+        for (void* p : list)
+          ::operator delete(p);
+      }
+    }
+
+    /// allocate a frame of size bytes.
+    void* allocate(size_t size) {
+      const size_t c = size_class(size);
+      if (c < free.size()) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!free[c].empty()) {
+          void* p = free[c].back();
+          free[c].pop_back();
+          return p;
+        }
+        return ::operator new((c + 1) * granularity);
+      }
+      return ::operator new(size);
+    }
+
+    /// deallocate a frame returned by allocate(size).
+    void deallocate(void* p, size_t size) {
+      const size_t c = size_class(size);
+      if (c < free.size()) {
+        std::lock_guard<std::mutex> lock(mutex);
+        free[c].push_back(p);
+      } else {
+        ::operator delete(p);
+      }
+    }
+
+  private:
+    static size_t size_class(size_t size) {
+      return (size + granularity - 1) / granularity - 1;
+    }
+
+    std::mutex                      mutex;
+    std::vector<std::vector<void*>> free;
+  };
+
+  /**
+   * \brief while a frame_pool_scope exists, the frames of tasks created on its
+   * thread are allocated from its pool. Scopes nest; destroying a scope
+   * restores the previous pool.
+   *
+   * The pool must outlive all frames allocated from it, but frames may be
+   * destroyed on any thread.
+   */
+  class frame_pool_scope {
+  public:
+    /**
+     * \brief allocate frames from pool.
+     * \tparam Pool pool type, e.g. \ref pc::frame_pool. Must provide
+     * `void* allocate(size_t)` and `void deallocate(void*, size_t)`.
+     * \param pool the pool
+     */
+    template <typename Pool>
+    explicit frame_pool_scope(Pool& pool)
+        : resource{&pool,
+                   [](void* p, size_t size) {
+                     return static_cast<Pool*>(p)->allocate(size);
+                   },
+                   [](void* p, void* frame, size_t size) {
+                     static_cast<Pool*>(p)->deallocate(frame, size);
+                   }},
+          previous(std::exchange(impl::frame_resource::current(), &resource)) {
+    }
+    frame_pool_scope(const frame_pool_scope&) = delete;
+    frame_pool_scope& operator=(const frame_pool_scope&) = delete;
+    /// destructor. Restores the previous pool.
+    ~frame_pool_scope() { impl::frame_resource::current() = previous; }
+
+  private:
+    impl::frame_resource  resource;
+    impl::frame_resource* previous;
+  };
+
+  template <typename T>
+  task<T> impl::task_promise<T>::get_return_object() noexcept {
+    return task<T>(std::coroutine_handle<task_promise>::from_promise(*this));
+  }
+
+  inline task<void> impl::task_promise<void>::get_return_object() noexcept {
+    return task<void>(std::coroutine_handle<task_promise>::from_promise(*this));
+  }
+
+  template <typename T>
+  void impl::task_group<T>::start_all(std::coroutine_handle<> h) {
+    waiter = h;
+    // one extra count, so that tasks which finish right away cannot resume
+    // the waiter before all tasks are started.
+    remaining.store(tasks.size() + 1, std::memory_order_relaxed);
+    for (auto& t : tasks) {
+      if (!t.handle) {
+        remaining.fetch_sub(1, std::memory_order_relaxed);
+        continue;
+      }
+      t.handle.promise().on_done = &task_done;
+      t.handle.promise().on_done_context = this;
+      t.handle.resume();
+    }
+  }
+
+  template <typename T>
+  std::coroutine_handle<> impl::task_group<T>::task_done(void* self) {
+    // the waiter is resumed by symmetric transfer from the final suspend
+    // point of the last task, i.e. not on top of its frame.
+    auto* group = static_cast<task_group*>(self);
+    if (group->count_down())
+      return group->waiter;
+    return std::noop_coroutine();
+  }
+
+  template <typename T>
+  auto impl::task_group<T>::await_resume() {
+    if constexpr (std::is_void_v<T>) {
+      for (auto& t : tasks)
+        std::move(t).operator co_await().await_resume();
+    } else {
+      std::vector<T> values;
+      values.reserve(tasks.size());
+      for (auto& t : tasks)
+        values.push_back(std::move(t).operator co_await().await_resume());
+      return values;
+    }
+  }
+
+  template <typename Ret, typename... Args>
+  class multicast_delegate<Ret(Args...)>::emit_awaiter
+      : public impl::task_group<impl::task_value_t<Ret>> {
+  public:
+    /// constructor
+    emit_awaiter(multicast_delegate& self, Args... args)
+        : self(&self), args(std::move(args)...) {}
+
+    bool await_ready() const noexcept { return self->delegates.empty(); }
+
+    bool await_suspend(std::coroutine_handle<> h) {
+      {
+        // changes made by the callables before their first suspension are
+        // deferred, like those made while invoking the multicast_delegate.
+        emit_guard guard(*self);
+        this->tasks.reserve(self->delegates.size());
+        for (auto& del : self->delegates)
+          this->tasks.push_back(std::apply(del, args));
+        this->start_all(h);
+        guard.finish();
+      }
+      return !this->count_down();
+    }
+
+  private:
+    multicast_delegate*               self;
+    std::tuple<std::decay_t<Args>...> args;
+  };
+
+  template <typename Ret, typename... Args>
+  typename multicast_delegate<Ret(Args...)>::emit_awaiter
+      multicast_delegate<Ret(Args...)>::emit_async(Args... args) {
+    return emit_awaiter(*this, std::move(args)...);
+  }
+} // namespace pc
+
+#endif
+#endif
@@ -14,27 +14,295 @@
 #ifndef PC_DELEGATE_HPP
 #define PC_DELEGATE_HPP
 #include <cstring>
+#include <functional>
 #include <new>
 #include <type_traits>
 
+/// \anchor PC_DELEGATE_NO_EXCEPTIONS
+/// defined if the library is built without exceptions, e.g. with
+/// -fno-exceptions. Define it to get the same behaviour with exceptions
+/// enabled. In this mode, the heap allocations of delegate use nothrow new and
+/// leave the delegate invalid if they fail, see delegate-allocation-failure.
+#if !defined(PC_DELEGATE_NO_EXCEPTIONS) && !defined(__cpp_exceptions) &&     \
+    !defined(__EXCEPTIONS) && !defined(_CPPUNWIND)
+#define PC_DELEGATE_NO_EXCEPTIONS
+#endif
+
 namespace pc {
 #ifndef GENERATING_DOCUMENTATION
   // forward declaration, intentionally left unimplemented
   template <typename>
   class delegate;
+
+  // forward declaration, defined in future.hpp
+  template <typename>
+  class future;
 #endif
 
   namespace impl {
-    struct vtable; // intentional forward declaration
+    struct vtable;          // intentional forward declaration
+    struct delegate_access; // intentional forward declaration
 
     /// \anchor max_storage_size
     /// the maximum size a callable can be before it gets allocated on the heap.
     /// 16 was chosen because this is the byte size of two pointers in a 64 bit
     /// system, i.e. just what is needed to invoke a member function on an
-    /// object without allocating with new.
+    /// object without allocating with new. Define PC_DELEGATE_MAX_STORAGE_SIZE
+    /// to a multiple of 8 to change it, e.g. to fit composed delegates, see
+    /// compose.hpp. It must be the same in all translation units.
+#ifdef PC_DELEGATE_MAX_STORAGE_SIZE
+    static constexpr size_t max_storage_size = PC_DELEGATE_MAX_STORAGE_SIZE;
+#else
     static constexpr size_t max_storage_size = 16u;
+#endif
+    static_assert(max_storage_size >= 16u && max_storage_size % 8u == 0,
+                  "PC_DELEGATE_MAX_STORAGE_SIZE must be a multiple of 8 and at "
+                  "least 16");
+
+    /// raw storage type of a delegate.
+    using storage_t = std::aligned_storage_t<max_storage_size, 8>;
+
+    /// size of a cache line. Used by the concurrent classes of this library to
+    /// keep data written by different threads apart.
+    static constexpr size_t cache_line_size = 64u;
+
+    /// \anchor param_t
+    /// type used to pass an argument of type T to a delegate and through its
+    /// invoke function. Reference types and small trivially copyable types are
+    /// passed as is, all other types by const reference. This way, calling a
+    /// delegate never copies an argument; only a callable which takes the
+    /// argument by value does.
+    template <typename T>
+    using param_t =
+        std::conditional_t<std::is_reference_v<T> ||
+                               (std::is_trivially_copyable_v<T> &&
+                                sizeof(T) <= 2 * sizeof(void*)),
+                           T, const T&>;
+
+    /// \brief class type and constness of a pointer to member function. Used
+    /// by delegate::expect() to find the invoke function of a bound member
+    /// function.
+    template <typename M>
+    struct member_func_traits {
+      static constexpr bool is_member_func = false;
+    };
+
+    /// specialization for non const member functions.
+    template <typename T, typename Ret, typename... Args>
+    struct member_func_traits<Ret (T::*)(Args...)> {
+      static constexpr bool is_member_func = true;
+      static constexpr bool is_const = false;
+      using class_type = T;
+    };
+
+    /// specialization for const member functions.
+    template <typename T, typename Ret, typename... Args>
+    struct member_func_traits<Ret (T::*)(Args...) const> {
+      static constexpr bool is_member_func = true;
+      static constexpr bool is_const = true;
+      using class_type = T;
+    };
+  } // namespace impl
+
+  /**
+   * \brief \anchor span-brief a non owning view of a contiguous sequence of
+   * T, used to pass batches to delegate::invoke_n(). Constructible from a
+   * pointer and a size, an array, or any container with data() and size(),
+   * e.g. std::vector, std::array or (C++20) std::span.
+   * \tparam T element type
+   */
+  template <typename T>
+  class span {
+  public:
+    /// construct an empty span.
+    constexpr span() noexcept = default;
+    /// construct from a pointer to the first element and the element count.
+    constexpr span(T* data, size_t size) noexcept : ptr(data), count(size) {}
+    /// construct from an array.
+    template <size_t N>
+    constexpr span(T (&array)[N]) noexcept : ptr(array), count(N) {}
+    /// construct from a contiguous container.
+    template <typename C,
+              std::enable_if_t<!std::is_same_v<std::decay_t<C>, span> &&
+                               std::is_convertible_v<
+                                   decltype(std::declval<C&>().data()), T*>>* =
+                  nullptr>
+    constexpr span(C& container) noexcept
+        : ptr(container.data()), count(container.size()) {}
+
+    /// get the pointer to the first element.
+    constexpr T* data() const noexcept { return ptr; }
+    /// get the number of elements.
+    constexpr size_t size() const noexcept { return count; }
+    /// query if the span has no elements.
+    constexpr bool empty() const noexcept { return count == 0; }
+    /// access the element at index i.
+    constexpr T& operator[](size_t i) const noexcept { return ptr[i]; }
+    /// get an iterator to the first element.
+    constexpr T* begin() const noexcept { return ptr; }
+    /// get an iterator past the last element.
+    constexpr T* end() const noexcept { return ptr + count; }
+
+  private:
+    T*     ptr{nullptr};
+    size_t count{0};
+  };
+
+  /// tag passed as first argument to the vectorized overload of a function
+  /// object, see delegate::invoke_n().
+  struct bulk_t {};
+  /// instance of \ref pc::bulk_t.
+  inline constexpr bulk_t bulk{};
+
+  /**
+   * \brief opts a function object type into the vectorized overload of
+   * delegate::invoke_n(). True if F declares a member type bulk_overload,
+   * e.g. `using bulk_overload = void;`. Specialize it for types which cannot
+   * declare one. A std::reference_wrapper<T> opts in if T does.
+   */
+  template <typename F, typename = void>
+  struct is_bulk_callable : std::false_type {};
+
+  template <typename F>
+  struct is_bulk_callable<F, std::void_t<typename F::bulk_overload>>
+      : std::true_type {};
+
+  template <typename T>
+  struct is_bulk_callable<std::reference_wrapper<T>> : is_bulk_callable<T> {};
+
+  namespace impl {
+    /// element type of the span an argument of type T is passed in by
+    /// delegate::invoke_n(). Arguments passed by value are read only.
+    template <typename T>
+    using bulk_element_t = std::conditional_t<std::is_reference_v<T>,
+                                              std::remove_reference_t<T>,
+                                              const std::remove_cv_t<T>>;
+
+    /// placeholder result of a delegate returning void.
+    struct void_result {};
+
+    /// element type of the span delegate::invoke_n() writes results into.
+    template <typename Ret>
+    using bulk_result_t =
+        std::conditional_t<std::is_void_v<Ret>, void_result,
+                           std::remove_cv_t<std::remove_reference_t<Ret>>>;
+
+    /// true if F has an overload processing a whole batch, i.e. if it opts in
+    /// with is_bulk_callable and can be called with bulk, one span per
+    /// argument and, unless Ret is void, a span for the results. Functions
+    /// without arguments have no batches. The opt-in comes first, so the body
+    /// of an unconstrained generic lambda is never instantiated with bulk.
+    template <typename F, typename Ret, typename... Args>
+    constexpr bool has_bulk_call() {
+      if constexpr (sizeof...(Args) == 0 || !is_bulk_callable<F>::value)
+        return false;
+      else if constexpr (std::is_void_v<Ret>)
+        return std::is_invocable_v<F&, bulk_t, span<bulk_element_t<Args>>...>;
+      else
+        return std::is_invocable_v<F&, bulk_t, span<bulk_element_t<Args>>...,
+                                   span<bulk_result_t<Ret>>>;
+    }
   } // namespace impl
 
+#ifndef GENERATING_DOCUMENTATION
+  // forward declaration, intentionally left unimplemented
+  template <typename>
+  struct c_callback;
+#endif
+
+  /**
+   * \brief \anchor c-callback-brief a C style callback, i.e. a function
+   * pointer taking a context pointer as first argument, together with the
+   * context. This is the shape C libraries take callbacks in.
+   * \tparam Ret return type of the callback
+   * \tparam Args argument types of the callback, after the context
+   */
+  template <typename Ret, typename... Args>
+  struct c_callback<Ret(Args...)> {
+    /// function pointer type.
+    using function_type = Ret (*)(void*, Args...);
+
+    function_type function{nullptr}; //< called with context
+    void*         context{nullptr};  //< first argument of function
+
+    /// call function with context and args.
+    Ret operator()(Args... args) const { return function(context, args...); }
+  };
+
+  /**
+   * \brief \anchor storage-kind-brief how a delegate stores its callable,
+   * see delegate::storage_kind().
+   */
+  enum class storage_kind {
+    null,    //< nothing is bound
+    trivial, //< stored inline and trivially copied, e.g. a free function
+    inplace, //< stored inline, but copied and destroyed by its own functions
+    heap     //< allocated on the heap, since it does not fit inline
+  };
+
+  /**
+   * \brief \anchor type-id-brief identifies a type without RTTI, i.e. it
+   * also works with -fno-rtti. Used by delegate::target_type().
+   *
+   * The id of a type is the address of a variable instantiated for it, so
+   * comparing two ids is comparing two pointers. Like the vtables of this
+   * library, ids are only unique within one executable or shared library,
+   * unless the linker merges such variables across them.
+   */
+  class type_id {
+  public:
+    /// construct the id of no type.
+    constexpr type_id() noexcept = default;
+
+    /**
+     * \brief get the id of T.
+     * \tparam T any type. Its cv qualifiers are ignored.
+     */
+    template <typename T>
+    static constexpr type_id of() noexcept {
+      return type_id(&tag<std::remove_cv_t<T>>);
+    }
+
+    /// query if this is the id of a type.
+    constexpr explicit operator bool() const noexcept { return id != nullptr; }
+
+    /// compare two ids.
+    friend constexpr bool operator==(type_id lhs, type_id rhs) noexcept {
+      return lhs.id == rhs.id;
+    }
+
+    /// compare two ids.
+    friend constexpr bool operator!=(type_id lhs, type_id rhs) noexcept {
+      return lhs.id != rhs.id;
+    }
+
+  private:
+    /// the variable whose address identifies T.
+    template <typename T>
+    static constexpr char tag{};
+
+    constexpr explicit type_id(const void* id) noexcept : id(id) {}
+
+    const void* id{nullptr};
+  };
+
+  /**
+   * \brief hit and miss counts of a call site using
+   * delegate::invoke_expecting(), or of the cache of a
+   * \ref pc::memoized_delegate<Ret(Args...)> "memoized_delegate". Not
+   * synchronized; use one instance per thread or per object.
+   */
+  struct inline_cache_stats {
+    size_t hits{0};   //< calls which were served by the fast path
+    size_t misses{0}; //< calls which fell back to the slow path
+
+    /// get the fraction of calls which hit, or 0 if there were none.
+    double hit_rate() const {
+      const size_t total = hits + misses;
+      return total == 0 ? 0.0 : static_cast<double>(hits) / total;
+    }
+  };
+
   /**
    * \brief \anchor delegate-brief This class can be used to execute free
    * functions, member functions and functors/ function objects, as long as they
@@ -45,8 +313,8 @@ namespace pc {
    * The class will never heap allocate when binding a free
    * function, object and member function, or a function object smaller than or
    * equal to [max_storage_size](#max_storage_size) (16) bytes. The total size
-   * of a delegate is 32 bytes. To increase the buffer size,
-   * change [max_storage_size](#max_storage_size).
+   * of a delegate is 32 bytes. To increase the buffer size, define
+   * PC_DELEGATE_MAX_STORAGE_SIZE, see [max_storage_size](#max_storage_size).
    *
    * \section delegate-invocation Invoking
    * Some details to consider when invoking a delegate:
@@ -56,11 +324,66 @@ namespace pc {
    * the value returned from a invalid delegate is always
    * either zero initialized or default constructed.
    *
+   * \section delegate-arguments Arguments
+   * Arguments are passed as [param_t](#param_t)<Args>, i.e. arguments which
+   * are not small and trivially copyable are passed by const reference down to
+   * the bound callable. Calling a delegate therefore only copies such an
+   * argument if the bound callable takes it by value. This is what allows a
+   * multicast_delegate to pass the same arguments to all its callables.
+   *
+   * \section delegate-guarded-invocation Guarded invocation
+   * A call through a delegate is an indirect call, which the compiler cannot
+   * inline. Call sites which are known to almost always call the same target
+   * can use invoke_expecting<Target>() or invoke_expecting<F>() instead. These
+   * compare the delegate's [invoke](#delegate-invoke) pointer, and for free
+   * and member functions the stored function pointer, with the expected
+   * target. On a match, the target is called directly and can be inlined.
+   * Otherwise, the delegate is invoked as usual. An optional
+   * \ref pc::inline_cache_stats counts the hits and misses of a call site.
+   *
+   * \section delegate-batches Batches
+   * invoke_n() invokes the delegate once per element of spans of arguments,
+   * with a single indirect call per batch. The loop over the elements is
+   * instantiated for the bound function object's type when it is bound, so
+   * the function object is called directly and can be inlined and
+   * vectorized. If the function object opts in with \ref pc::is_bulk_callable
+   * and has an overload taking \ref pc::bulk followed by the spans, it is
+   * called once with the whole batch instead.
+   * Free and member functions are called once per element.
+   *
+   * \section delegate-c-callbacks C callbacks
+   * [invoke](#delegate-invoke) and the address of *storage* already have the
+   * shape of a C callback and its context. as_c_callback() returns them as a
+   * \ref pc::c_callback "c_callback", which a C library can call without any
+   * trampoline in between. Conversely, a delegate constructed from a C
+   * callback stores the function pointer and the context inline, like a
+   * member function.
+   *
+   * \section delegate-introspection Introspection
+   * storage_kind() tells how the bound callable is stored, which shows e.g.
+   * which delegates allocate. target_type() identifies the type of the stored
+   * callable with a \ref pc::type_id "type_id", and target<T>() returns a
+   * pointer to it if it is a T. Neither needs RTTI: every
+   * [table](#delegate-table) is created for one stored type and holds both,
+   * so the delegate itself does not grow.
+   *
+   * \section delegate-allocation-failure Allocation failure
+   * Only function objects which do not fit into *storage* are allocated,
+   * when they are bound and when the delegate is copied. By default, a
+   * failing allocation throws std::bad_alloc. try_bind() and try_copy() use
+   * nothrow new instead and return false on failure, leaving the delegate
+   * unchanged. If [PC_DELEGATE_NO_EXCEPTIONS](#PC_DELEGATE_NO_EXCEPTIONS) is
+   * defined, bind(), the copy constructor and the copy assignment behave
+   * like these too, but cannot report the failure. They leave the delegate
+   * invalid instead, which is_valid() detects. Copying the function object
+   * itself is not covered, e.g. if it holds a container which allocates.
+   *
    * \section delegate-theory-of-operation Theory of operation
    * The class consists of three main elements.
    *  1. a raw memory buffer of 16 bytes called *storage*
    *  2. a pointer to a free function with
-   * signature Ret(void*,Args...) called [invoke](#delegate-invoke) and
+   * signature Ret(void*,param_t<Args>...) called [invoke](#delegate-invoke)
+   * and
    *  3. a pointer to a static vtable called [table](#delegate-table).
    *
    * The raw memory buffer is used to hold the callable data, a.k.a. either a
@@ -106,6 +429,20 @@ namespace pc {
      */
     delegate(Ret (*free_function)(Args...));
 
+    /**
+     * \brief construct from a C callback, i.e. a function pointer and the
+     * context it is called with.
+     * \param function pointer to function taking the context first
+     * \param context context passed to function
+     */
+    delegate(Ret (*function)(void*, Args...), void* context);
+
+    /**
+     * \brief construct from a C callback.
+     * \param callback function pointer and context
+     */
+    explicit delegate(c_callback<Ret(Args...)> callback);
+
     /**
      * construct from object and pointer to member function
      * \tparam T object type
@@ -173,7 +510,119 @@ namespace pc {
      * \param args arguments
      * \return Ret return type
      */
-    Ret operator()(Args... args);
+    Ret operator()(impl::param_t<Args>... args);
+
+    /**
+     * \brief invoke the delegate on an executor. The arguments are copied into
+     * the future's shared state, which is taken from a pool instead of being
+     * allocated per call.
+     * \note Defined in future.hpp, which must be included to use this
+     * function. The delegate must not be modified or destroyed until the
+     * returned future is ready.
+     * \tparam Executor executor type, e.g. \ref pc::thread_pool. Must provide
+     * submit(delegate<void()>).
+     * \param executor executor to invoke the delegate on
+     * \param args arguments
+     * \return future<Ret> the value returned by the bound callable
+     */
+    template <typename Executor>
+    future<Ret> invoke_async(Executor& executor, Args... args);
+
+    /**
+     * \brief compose this delegate with a following stage, see
+     * \ref pc::pipeline "pipeline". The delegate is referenced, not copied,
+     * and must outlive the composition.
+     * \note Defined in compose.hpp, which must be included to use this
+     * function. The same applies to map() and filter().
+     * \tparam F stage type
+     * \param f callable invoked with the result of this delegate, or with its
+     * arguments if Ret is void
+     * \return a pipeline, which can be bound to a delegate
+     */
+    template <typename F>
+    auto then(F&& f);
+
+    /**
+     * \brief compose this delegate with a stage transforming its result. Like
+     * then(), but Ret must not be void.
+     */
+    template <typename F>
+    auto map(F&& f);
+
+    /**
+     * \brief compose this delegate with a predicate. Following stages only run
+     * for results the predicate accepts, see \ref pc::pipeline "pipeline".
+     */
+    template <typename P>
+    auto filter(P&& p);
+
+    /**
+     * \brief invoke the delegate for each element of a batch of arguments.
+     * \see delegate-batches
+     * \param args one span per argument. The i-th call gets the i-th element
+     * of each.
+     * \param out receives the i-th result at index i. Ignored, and may be
+     * omitted, if Ret is void.
+     * \note The batch size is the smallest size of args and, unless Ret is
+     * void, out. Returned references are copied into out.
+     */
+    void invoke_n(span<impl::bulk_element_t<Args>>... args,
+                  span<impl::bulk_result_t<Ret>> out = {});
+
+    /**
+     * \brief query if Target is bound, i.e. if invoke_expecting<Target>()
+     * calls it directly.
+     * \tparam Target pointer to the free function Ret(Args...) or the
+     * (const) member function expected to be bound.
+     */
+    template <auto Target>
+    bool expect() const noexcept;
+
+    /**
+     * \brief query if a function object of type F is bound, i.e. if
+     * invoke_expecting<F>() calls it directly.
+     * \tparam F function object type, as it was decayed when bound.
+     */
+    template <typename F>
+    bool expect() const noexcept;
+
+    /**
+     * \brief invoke the delegate, calling Target directly if it is bound.
+     * \see delegate-guarded-invocation
+     * \tparam Target pointer to the free function Ret(Args...) or the
+     * (const) member function expected to be bound.
+     * \param args arguments
+     * \return Ret return value of the bound callable
+     */
+    template <auto Target>
+    Ret invoke_expecting(impl::param_t<Args>... args);
+
+    /**
+     * \brief invoke the delegate, calling the function object directly if it
+     * is of type F.
+     * \see delegate-guarded-invocation
+     * \tparam F function object type, as it was decayed when bound.
+     * \param args arguments
+     * \return Ret return value of the bound callable
+     */
+    template <typename F>
+    Ret invoke_expecting(impl::param_t<Args>... args);
+
+    /**
+     * \brief same as invoke_expecting<Target>(args...), but counts the hit or
+     * miss in stats.
+     */
+    template <auto Target>
+    Ret invoke_expecting(inline_cache_stats& stats,
+                         impl::param_t<Args>... args);
+
+    /**
+     * \brief same as invoke_expecting<F>(args...), but counts the hit or miss
+     * in stats.
+     */
+    template <typename F>
+    Ret invoke_expecting(inline_cache_stats& stats,
+                         impl::param_t<Args>... args);
 
     /**
      * \brief bind a free function.
@@ -181,6 +630,27 @@ namespace pc {
      */
     void bind(Ret (*free_function)(Args...)) noexcept;
 
+    /**
+     * \brief bind a C callback, i.e. a function pointer and the context it is
+     * called with. Stored inline and trivially copied, like a free function.
+     * \param function pointer to function taking the context first
+     * \param context context passed to function
+     */
+    void bind(Ret (*function)(void*, Args...), void* context) noexcept;
+
+    /**
+     * \brief get the delegate as a C callback. Calling the returned function
+     * with the returned context invokes the delegate directly, without
+     * allocating or a trampoline. The context points into the delegate,
+     * which must therefore neither be moved nor destroyed, and not be
+     * rebound if the callback is used afterwards.
+     * \note Only available if all arguments are passed as is, i.e. if
+     * [param_t](#param_t)<Args> is Args for all Args. Large arguments, which
+     * are passed by const reference, cannot be passed from C.
+     * \return c_callback<Ret(Args...)> function pointer and context
+     */
+    c_callback<Ret(Args...)> as_c_callback() noexcept;
+
     /**
      * \brief bind an object and member function.
      * \tparam T object type
@@ -209,6 +679,30 @@ namespace pc {
                   std::decay_t<F>, delegate<Ret(Args...)>>>* = nullptr>
     void bind(F&& f);
 
+    /**
+     * \brief bind a function object, reporting allocation failure instead of
+     * throwing. Binding anything else never allocates.
+     * \see delegate-allocation-failure
+     * \tparam F function object type
+     * \param f function object instance
+     * \return true f is bound
+     * \return false allocating f failed. The delegate is unchanged.
+     */
+    template <typename F,
+              std::enable_if_t<!std::is_same_v<
+                  std::decay_t<F>, delegate<Ret(Args...)>>>* = nullptr>
+    bool try_bind(F&& f);
+
+    /**
+     * \brief copy assign other, reporting allocation failure instead of
+     * throwing.
+     * \see delegate-allocation-failure
+     * \param other delegate to copy
+     * \return true this is a copy of other
+     * \return false allocating the copy failed. The delegate is unchanged.
+     */
+    bool try_copy(const delegate& other);
+
     /**
      * \brief query if a callable is bound to the delegate.
      * \return true callable is bound to the delegate
@@ -216,6 +710,36 @@ namespace pc {
      */
     bool is_valid() const;
 
+    /**
+     * \brief get how the bound callable is stored.
+     * \see delegate-introspection
+     * \return storage_kind::null if no callable is bound
+     */
+    pc::storage_kind storage_kind() const noexcept;
+
+    /**
+     * \brief get the type of the stored callable, without RTTI.
+     * \see delegate-introspection
+     * \return the id of the function object type as it was decayed when
+     * bound, of Ret(*)(Args...) for a free function, of
+     * \ref pc::c_callback "c_callback<Ret(Args...)>" for a C callback, or of
+     * impl::mfn_holder_t/impl::const_mfn_holder_t for a member function. The
+     * id of no type if no callable is bound.
+     */
+    type_id target_type() const noexcept;
+
+    /**
+     * \brief get a pointer to the stored callable.
+     * \tparam T type of the stored callable, see target_type().
+     * \return T* pointer to the stored callable, or nullptr if it is not a T.
+     */
+    template <typename T>
+    T* target() noexcept;
+
+    /// \copydoc target()
+    template <typename T>
+    const T* target() const noexcept;
+
     /**
      * \brief reset the delegate. This unbinds the callable from the delegate.
      * \note is_valid() returns false after a call to this function.
@@ -223,39 +747,90 @@ namespace pc {
     void reset();
 
   private:
+    friend struct impl::delegate_access;
+
     /// \brief knows how to invoke a free function.
-    static Ret free_func_invoke(void* object, Args... args);
+    static Ret free_func_invoke(void* object, impl::param_t<Args>... args);
+
+    /// \brief knows how to invoke a \ref pc::c_callback "c_callback".
+    static Ret c_callback_invoke(void* object, impl::param_t<Args>... args);
 
     /// \brief knows how to invoke \ref pc::impl::mfn_holder_t<T>.
     /// \tparam T object type
     template <typename T>
-    static Ret mfn_invoke(void* object, Args... args);
+    static Ret mfn_invoke(void* object, impl::param_t<Args>... args);
 
     /// \brief knows how to invoke \ref pc::impl::const_mfn_holder_t<T>.
     /// \tparam T object type
     template <typename T>
-    static Ret const_mfn_invoke(void* object, Args... args);
+    static Ret const_mfn_invoke(void* object, impl::param_t<Args>... args);
 
     /// \brief knows to to invoke a inline stored functor.
     /// \tparam F Functor type
     template <typename F>
-    static Ret inline_invoke(void* f, Args... args);
+    static Ret inline_invoke(void* f, impl::param_t<Args>... args);
 
     /// \brief knows how to invoke a heap stored functor.
     /// \tparam F Functor type
     template <typename F>
-    static Ret heap_invoke(void* f, Args... args);
+    static Ret heap_invoke(void* f, impl::param_t<Args>... args);
 
     /// \brief invokes nothing.
     /// Returns a statically allocated value if Ret != void.
     /// With this function, no switch/if is needed to check if invoke is valid
     /// when the delegate gets called.
-    static Ret null_invoke(void*, Args...);
+    static Ret null_invoke(void*, impl::param_t<Args>...);
 
     /// raw storage type
-    using Storage_t = std::aligned_storage_t<pc::impl::max_storage_size, 8>;
+    using Storage_t = impl::storage_t;
     /// type of invoke member
-    using InvokeFuncPtr_t = Ret (*)(void*, Args...);
+    using InvokeFuncPtr_t = Ret (*)(void*, impl::param_t<Args>...);
+    /// type of the function processing a batch, see invoke_n().
+    using BulkFuncPtr_t = void (*)(InvokeFuncPtr_t, void*, size_t,
+                                   impl::bulk_element_t<Args>*...,
+                                   impl::bulk_result_t<Ret>*);
+
+    /// true if results can be written to the out span of invoke_n().
+    static constexpr bool has_invoke_n =
+        std::is_void_v<Ret> ||
+        std::is_assignable_v<impl::bulk_result_t<Ret>&, Ret>;
+
+    /// the vtable of a callable bound to this delegate type, extended by the
+    /// function processing a batch and the introspection data. table always
+    /// points to one of these.
+    struct table_t;
+
+    /// \brief processes a batch by calling invoke once per element. Like
+    /// functor_invoke_n, it does nothing if !has_invoke_n, in which case
+    /// invoke_n() does not compile. Used for
+    /// free and member functions and the invalid delegate.
+    static void invoke_each(InvokeFuncPtr_t invoke, void* object, size_t n,
+                            impl::bulk_element_t<Args>*... args,
+                            impl::bulk_result_t<Ret>* out);
+
+    /// \brief processes a batch with a function object of type F, either by
+    /// calling it directly once per element or by calling its vectorized
+    /// overload.
+    /// \tparam F Functor type
+    /// \tparam Heap true if the functor is heap allocated
+    template <typename F, bool Heap>
+    static void functor_invoke_n(InvokeFuncPtr_t, void* f, size_t n,
+                                 impl::bulk_element_t<Args>*... args,
+                                 impl::bulk_result_t<Ret>* out);
+
+    /// \brief provides the table of an inline stored function object.
+    template <typename F>
+    static const impl::vtable* inline_table();
+    /// \brief provides the table of a heap allocated function object.
+    template <typename F>
+    static const impl::vtable* heap_table();
+    /// \brief provides the table of free and member functions and C
+    /// callbacks.
+    /// \tparam T stored type
+    template <typename T>
+    static const impl::vtable* trivial_table();
+    /// \brief provides the table of the invalid delegate.
+    static const impl::vtable* null_table();
 
     // clang-format off
     /// \anchor delegate-storage
@@ -322,9 +897,10 @@ namespace pc {
      * member functions implement the functions needed by the delegate class.
      */
     struct vtable {
-      void (*copy)(void* dest, const void* src); //< copies callables
-      void (*move)(void* dest, void* src);       //< moves callables
-      void (*destroy)(void* dest);               //< destroys callables
+      void (*copy)(void* dest, const void* src);     //< copies callables
+      bool (*try_copy)(void* dest, const void* src); //< nothrow new copy
+      void (*move)(void* dest, void* src);           //< moves callables
+      void (*destroy)(void* dest);                   //< destroys callables
 
       /// \brief copies inline function objects.
       /// \tparam T function object type
@@ -348,6 +924,16 @@ namespace pc {
       /// \tparam T function object type
       template <typename T>
       static void heap_copy(void* dest, const void* source);
+      /// \brief like heap_copy, but allocates with nothrow new.
+      /// \tparam T function object type
+      /// \return false if the allocation failed. dest is unchanged.
+      template <typename T>
+      static bool heap_try_copy(void* dest, const void* source);
+
+      /// \brief try_copy for callables whose copy does not allocate.
+      /// \tparam Copy the copy function
+      template <void (*Copy)(void*, const void*)>
+      static bool infallible_copy(void* dest, const void* source);
       /// \brief moves functor allocated on the heap into dest.
       /// \tparam T function object type
       template <typename T>
@@ -384,17 +970,67 @@ namespace pc {
       /// control flow, i.e. the delegate never has to check if table is nullptr
       static const impl::vtable* make_null();
     };
+
+    /**
+     * \brief gives the other classes of this library access to the members of
+     * a delegate, e.g. to store them in a different layout.
+     */
+    struct delegate_access {
+      /// get the storage of d.
+      template <typename D>
+      static storage_t& storage(D& d) {
+        return d.storage;
+      }
+      /// get the invoke function pointer of d.
+      template <typename D>
+      static auto& invoke(D& d) {
+        return d.invoke;
+      }
+      /// get the vtable pointer of d.
+      template <typename D>
+      static const vtable*& table(D& d) {
+        return d.table;
+      }
+      /// set d up to do nothing, without destroying the stored callable.
+      /// Called after the callable has been moved out of d's storage with its
+      /// vtable's move function.
+      template <typename D>
+      static void release(D& d) {
+        d.table = D::null_table();
+        d.invoke = &D::null_invoke;
+      }
+    };
   } // namespace impl
 
+  template <typename Ret, typename... Args>
+  struct delegate<Ret(Args...)>::table_t : impl::vtable {
+    BulkFuncPtr_t    invoke_n; //< processes a batch
+    pc::storage_kind kind;     //< how the callable is stored
+    type_id          target;   //< type of the stored callable
+  };
+
   template <typename Ret, typename... Args>
   delegate<Ret(Args...)>::delegate()
-      : storage{0}, invoke(&null_invoke), table(impl::vtable::make_null()) {}
+      : storage{0}, invoke(&null_invoke), table(null_table()) {}
 
   template <typename Ret, typename... Args>
   delegate<Ret(Args...)>::delegate(Ret (*free_function)(Args...)) : delegate() {
     bind(free_function);
   }
 
+  template <typename Ret, typename... Args>
+  delegate<Ret(Args...)>::delegate(Ret (*function)(void*, Args...),
+                                   void* context)
+      : delegate() {
+    bind(function, context);
+  }
+
+  template <typename Ret, typename... Args>
+  delegate<Ret(Args...)>::delegate(c_callback<Ret(Args...)> callback)
+      : delegate() {
+    bind(callback.function, callback.context);
+  }
+
   template <typename Ret, typename... Args>
   template <typename T>
   delegate<Ret(Args...)>::delegate(T& object, Ret (T::*member_func)(Args...))
@@ -414,7 +1050,7 @@ namespace pc {
   template <typename F, std::enable_if_t<!std::is_same_v<
                             std::decay_t<F>, delegate<Ret(Args...)>>>*>
   delegate<Ret(Args...)>::delegate(F&& f) : delegate() {
-    bind(std::forward<std::decay_t<F>>(f));
+    bind(std::forward<F>(f));
   }
 
   template <typename Ret, typename... Args>
@@ -422,8 +1058,17 @@ namespace pc {
     /// \anchor delegate-copy-ctor-src
     // no check needed in case other is invalid, because table will always point
     // to a valid vtable instance.
+#ifdef PC_DELEGATE_NO_EXCEPTIONS
+    // without exceptions, a failed allocation leaves this delegate invalid.
+    if (!other.table->try_copy(&storage, &other.storage)) {
+      table = null_table();
+      invoke = &null_invoke;
+      return;
+    }
+#else
     other.table->copy(&storage,
                       &other.storage); // other knows how to copy itself
+#endif
     table = other.table;
     invoke = other.invoke;
   }
@@ -436,7 +1081,7 @@ namespace pc {
     table = other.table;
     invoke = other.invoke;
     // the other delegate will be invalid after the move.
-    other.table = impl::vtable::make_null();
+    other.table = null_table();
     other.invoke = &null_invoke;
   }
 
@@ -444,21 +1089,33 @@ namespace pc {
   delegate<Ret(Args...)>&
       delegate<Ret(Args...)>::operator=(const delegate& other) {
     /// \anchor delegate-copy-assign-src
+    if (this == &other)
+      return *this;
+#ifdef PC_DELEGATE_NO_EXCEPTIONS
+    // without exceptions, a failed allocation leaves this delegate invalid.
+    if (!try_copy(other))
+      reset();
+    return *this;
+#else
     table->destroy(&storage); // destroy callable stored in this first
     other.table->copy(&storage, &other.storage); // then copy from other
     invoke = other.invoke;
     table = other.table;
     return *this;
+#endif
   }
 
   template <typename Ret, typename... Args>
   delegate<Ret(Args...)>& delegate<Ret(Args...)>::operator=(delegate&& other) {
     /// \anchor delegate-move-assign-src
+    if (this == &other)
+      return *this;
     table->destroy(&storage); // destroy callable stored in this first
     other.table->move(&storage, &other.storage); // then move from other.
     invoke = other.invoke;
+    table = other.table;
     // other will be invalid after the move
-    other.table = impl::vtable::make_null();
+    other.table = null_table();
     other.invoke = &null_invoke;
     return *this;
   }
@@ -469,11 +1126,115 @@ namespace pc {
   }
 
   template <typename Ret, typename... Args>
-  Ret delegate<Ret(Args...)>::operator()(Args... args) {
+  Ret delegate<Ret(Args...)>::operator()(impl::param_t<Args>... args) {
     // because invoke will always contain a valid address of a function, no
     // check needed to execute this.
     return static_cast<Ret>(
-        invoke(static_cast<void*>(&storage), std::forward<Args>(args)...));
+        invoke(static_cast<void*>(&storage),
+               std::forward<impl::param_t<Args>>(args)...));
+  }
+
+  template <typename Ret, typename... Args>
+  void delegate<Ret(Args...)>::invoke_n(
+      span<impl::bulk_element_t<Args>>... args,
+      span<impl::bulk_result_t<Ret>> out) {
+    static_assert(sizeof...(Args) > 0,
+                  "invoke_n needs at least one argument to form a batch");
+    static_assert(has_invoke_n,
+                  "invoke_n needs results which can be assigned to out");
+    size_t n = static_cast<size_t>(-1);
+    ((n = args.size() < n ? args.size() : n), ...);
+    if constexpr (!std::is_void_v<Ret>)
+      n = out.size() < n ? out.size() : n;
+    // the only indirect call for the whole batch.
+    static_cast<const table_t*>(table)->invoke_n(
+        invoke, static_cast<void*>(&storage), n, args.data()..., out.data());
+  }
+
+  template <typename Ret, typename... Args>
+  template <auto Target>
+  bool delegate<Ret(Args...)>::expect() const noexcept {
+    using target_t = decltype(Target);
+    using traits = impl::member_func_traits<target_t>;
+    if constexpr (traits::is_member_func) {
+      using T = typename traits::class_type;
+      if constexpr (traits::is_const) {
+        using holder = impl::const_mfn_holder_t<T, Ret, Args...>;
+        return invoke == &const_mfn_invoke<T> &&
+               reinterpret_cast<const holder*>(&storage)->func == Target;
+      } else {
+        using holder = impl::mfn_holder_t<T, Ret, Args...>;
+        return invoke == &mfn_invoke<T> &&
+               reinterpret_cast<const holder*>(&storage)->func == Target;
+      }
+    } else {
+      static_assert(std::is_same_v<target_t, Ret (*)(Args...)>,
+                    "Target must be a pointer to a free function with the "
+                    "signature Ret(Args...) or a pointer to member function");
+      return invoke == &free_func_invoke &&
+             *reinterpret_cast<const target_t*>(&storage) == Target;
+    }
+  }
+
+  template <typename Ret, typename... Args>
+  template <typename F>
+  bool delegate<Ret(Args...)>::expect() const noexcept {
+    if constexpr (sizeof(F) <= impl::max_storage_size)
+      return invoke == &inline_invoke<F>;
+    else
+      return invoke == &heap_invoke<F>;
+  }
+
+  template <typename Ret, typename... Args>
+  template <auto Target>
+  Ret delegate<Ret(Args...)>::invoke_expecting(impl::param_t<Args>... args) {
+    if (!expect<Target>())
+      return (*this)(std::forward<impl::param_t<Args>>(args)...);
+    // the target is a constant here, so the compiler can inline it.
+    using traits = impl::member_func_traits<decltype(Target)>;
+    if constexpr (traits::is_member_func) {
+      using T = typename traits::class_type;
+      using holder =
+          std::conditional_t<traits::is_const,
+                             impl::const_mfn_holder_t<T, Ret, Args...>,
+                             impl::mfn_holder_t<T, Ret, Args...>>;
+      T* object = reinterpret_cast<holder*>(&storage)->t;
+      return static_cast<Ret>(
+          (object->*Target)(std::forward<impl::param_t<Args>>(args)...));
+    } else {
+      return static_cast<Ret>(
+          Target(std::forward<impl::param_t<Args>>(args)...));
+    }
+  }
+
+  template <typename Ret, typename... Args>
+  template <typename F>
+  Ret delegate<Ret(Args...)>::invoke_expecting(impl::param_t<Args>... args) {
+    if (!expect<F>())
+      return (*this)(std::forward<impl::param_t<Args>>(args)...);
+    // a direct call of the invoke function, which the compiler can inline.
+    if constexpr (sizeof(F) <= impl::max_storage_size)
+      return inline_invoke<F>(static_cast<void*>(&storage),
+                              std::forward<impl::param_t<Args>>(args)...);
+    else
+      return heap_invoke<F>(static_cast<void*>(&storage),
+                            std::forward<impl::param_t<Args>>(args)...);
+  }
+
+  template <typename Ret, typename... Args>
+  template <auto Target>
+  Ret delegate<Ret(Args...)>::invoke_expecting(inline_cache_stats& stats,
+                                               impl::param_t<Args>... args) {
+    ++(expect<Target>() ? stats.hits : stats.misses);
+    return invoke_expecting<Target>(std::forward<impl::param_t<Args>>(args)...);
+  }
+
+  template <typename Ret, typename... Args>
+  template <typename F>
+  Ret delegate<Ret(Args...)>::invoke_expecting(inline_cache_stats& stats,
+                                               impl::param_t<Args>... args) {
+    ++(expect<F>() ? stats.hits : stats.misses);
+    return invoke_expecting<F>(std::forward<impl::param_t<Args>>(args)...);
   }
 
   template <typename Ret, typename... Args>
@@ -481,17 +1242,36 @@ namespace pc {
     using type = Ret (*)(Args...);
     reset();
     invoke = &free_func_invoke;
-    table = impl::vtable::make_trivial();
+    table = trivial_table<type>();
     new (&storage) type(free_function);
   }
 
+  template <typename Ret, typename... Args>
+  void delegate<Ret(Args...)>::bind(Ret (*function)(void*, Args...),
+                                    void* context) noexcept {
+    reset();
+    invoke = &c_callback_invoke;
+    table = trivial_table<c_callback<Ret(Args...)>>();
+    new (&storage) c_callback<Ret(Args...)>{function, context};
+  }
+
+  template <typename Ret, typename... Args>
+  c_callback<Ret(Args...)> delegate<Ret(Args...)>::as_c_callback() noexcept {
+    static_assert(
+        (std::is_same_v<impl::param_t<Args>, Args> && ...),
+        "arguments passed by const reference cannot be passed from C");
+    // with all arguments passed as is, invoke already has the signature
+    // Ret(void*, Args...).
+    return {invoke, static_cast<void*>(&storage)};
+  }
+
   template <typename Ret, typename... Args>
   template <typename T>
   void delegate<Ret(Args...)>::bind(T& object,
                                     Ret (T::*member_func)(Args...)) noexcept {
     reset();
     invoke = &mfn_invoke<T>;
-    table = impl::vtable::make_trivial();
+    table = trivial_table<impl::mfn_holder_t<T, Ret, Args...>>();
     new (&storage) impl::mfn_holder_t<T, Ret, Args...>{object, member_func};
     static_assert(sizeof(impl::mfn_holder_t<T, Ret, Args...>) <=
                       pc::impl::max_storage_size,
@@ -506,7 +1286,7 @@ namespace pc {
                                                    const) noexcept {
     reset();
     invoke = &const_mfn_invoke<T>;
-    table = impl::vtable::make_trivial();
+    table = trivial_table<impl::const_mfn_holder_t<T, Ret, Args...>>();
     new (&storage)
         impl::const_mfn_holder_t<T, Ret, Args...>(object, member_func);
     static_assert(sizeof(impl::const_mfn_holder_t<T, Ret, Args...>) <=
@@ -524,19 +1304,65 @@ namespace pc {
     static_assert(
         std::is_invocable_r_v<Ret, decltype(f), Args...>,
         "The function object must have a call signature of Ret(Args...)");
+#ifdef PC_DELEGATE_NO_EXCEPTIONS
+    // without exceptions, a failed allocation leaves this delegate invalid.
+    if (!try_bind(std::forward<F>(f)))
+      reset();
+#else
     reset();
-    if constexpr (sizeof(std::decay_t<F>) <= 16) {
+    if constexpr (sizeof(std::decay_t<F>) <= impl::max_storage_size) {
       // store the f inline with placement new into storage.
       new (&storage) std::decay_t<F>(std::forward<F>(f));
-      table = impl::vtable::template make_inline<std::decay_t<F>>();
+      table = inline_table<std::decay_t<F>>();
       invoke = &inline_invoke<std::decay_t<F>>;
     } else {
       // cannot store inline -> have to use the heap
       *reinterpret_cast<std::decay_t<F>**>(&storage) =
           new std::decay_t<F>(std::forward<F>(f));
-      table = impl::vtable::template make_heap<std::decay_t<F>>();
+      table = heap_table<std::decay_t<F>>();
       invoke = &heap_invoke<std::decay_t<F>>;
     }
+#endif
+  }
+
+  template <typename Ret, typename... Args>
+  template <typename F, std::enable_if_t<!std::is_same_v<
+                            std::decay_t<F>, delegate<Ret(Args...)>>>*>
+  bool delegate<Ret(Args...)>::try_bind(F&& f) {
+    using type = std::decay_t<F>;
+    static_assert(
+        std::is_invocable_r_v<Ret, decltype(f), Args...>,
+        "The function object must have a call signature of Ret(Args...)");
+    if constexpr (sizeof(type) <= impl::max_storage_size) {
+      reset();
+      new (&storage) type(std::forward<F>(f));
+      table = inline_table<type>();
+      invoke = &inline_invoke<type>;
+    } else {
+      // allocate before resetting, so that a failure leaves this unchanged.
+      type* heap_f = new (std::nothrow) type(std::forward<F>(f));
+      if (heap_f == nullptr)
+        return false;
+      reset();
+      *reinterpret_cast<type**>(&storage) = heap_f;
+      table = heap_table<type>();
+      invoke = &heap_invoke<type>;
+    }
+    return true;
+  }
+
+  template <typename Ret, typename... Args>
+  bool delegate<Ret(Args...)>::try_copy(const delegate& other) {
+    if (this == &other)
+      return true;
+    // copy into a temporary first, so that a failure leaves this unchanged.
+    delegate copy;
+    if (!other.table->try_copy(&copy.storage, &other.storage))
+      return false;
+    copy.table = other.table;
+    copy.invoke = other.invoke;
+    *this = std::move(copy);
+    return true;
   }
 
   template <typename Ret, typename... Args>
@@ -544,28 +1370,67 @@ namespace pc {
     return invoke != &null_invoke;
   }
 
+  template <typename Ret, typename... Args>
+  storage_kind delegate<Ret(Args...)>::storage_kind() const noexcept {
+    return static_cast<const table_t*>(table)->kind;
+  }
+
+  template <typename Ret, typename... Args>
+  type_id delegate<Ret(Args...)>::target_type() const noexcept {
+    return static_cast<const table_t*>(table)->target;
+  }
+
+  template <typename Ret, typename... Args>
+  template <typename T>
+  T* delegate<Ret(Args...)>::target() noexcept {
+    const auto* t = static_cast<const table_t*>(table);
+    if (t->target != type_id::of<T>())
+      return nullptr;
+    // a heap allocated callable is stored as pointer to it.
+    if (t->kind == pc::storage_kind::heap)
+      return *reinterpret_cast<T**>(&storage);
+    return reinterpret_cast<T*>(&storage);
+  }
+
+  template <typename Ret, typename... Args>
+  template <typename T>
+  const T* delegate<Ret(Args...)>::target() const noexcept {
+    return const_cast<delegate*>(this)->template target<T>();
+  }
+
   template <typename Ret, typename... Args>
   void delegate<Ret(Args...)>::reset() {
     table->destroy(&storage); // properly deleting our contained object.
     invoke = &null_invoke;    // setting the delegate up to do nothing.
-    table = impl::vtable::make_null(); // setting the table up to do
-                                       // nothing.
+    table = null_table(); // setting the table up to do nothing.
   }
 
   template <typename Ret, typename... Args>
-  Ret delegate<Ret(Args...)>::free_func_invoke(void* object, Args... args) {
+  Ret delegate<Ret(Args...)>::free_func_invoke(
+      void* object, impl::param_t<Args>... args) {
     // storage will contain a function pointer. The void* param will be the
     // address of storage. This means the real type of the param is 'pointer to
     // function pointer'.
     using type = Ret (*)(Args...); // type alias to easily cast
     // static_cast to Ret to account for the case where Ret = void. Else there
     // would be a compile error.
-    return static_cast<Ret>((*static_cast<type*>(object))(args...));
+    return static_cast<Ret>((*static_cast<type*>(object))(
+        std::forward<impl::param_t<Args>>(args)...));
+  }
+
+  template <typename Ret, typename... Args>
+  Ret delegate<Ret(Args...)>::c_callback_invoke(
+      void* object, impl::param_t<Args>... args) {
+    // storage will contain a c_callback<Ret(Args...)> instance inline.
+    auto* callback = static_cast<c_callback<Ret(Args...)>*>(object);
+    return static_cast<Ret>(callback->function(
+        callback->context, std::forward<impl::param_t<Args>>(args)...));
   }
 
   template <typename Ret, typename... Args>
   template <typename T>
-  Ret delegate<Ret(Args...)>::mfn_invoke(void* object, Args... args) {
+  Ret delegate<Ret(Args...)>::mfn_invoke(
+      void* object, impl::param_t<Args>... args) {
     // storage will contain a mfn_holder_t<T, Ret, Args...> instance inline. As
     // such, object's real type is 'pointer to mfn_holder_t<T, Ret, Args...>'.
     using type = impl::mfn_holder_t<T, Ret, Args...>;
@@ -575,48 +1440,135 @@ namespace pc {
     // t.
     return static_cast<Ret>(
         (static_cast<type*>(object)->t->*(static_cast<type*>(object)->func))(
-            args...));
+            std::forward<impl::param_t<Args>>(args)...));
   }
 
   template <typename Ret, typename... Args>
   template <typename T>
-  Ret delegate<Ret(Args...)>::const_mfn_invoke(void* object, Args... args) {
+  Ret delegate<Ret(Args...)>::const_mfn_invoke(
+      void* object, impl::param_t<Args>... args) {
     // look at mfn_invoke for detailed explanation. exactly the same principle,
     // just with the type being const_mfn_holder_t<T, Ret, Args...>.
     using type = impl::const_mfn_holder_t<T, Ret, Args...>;
     return static_cast<Ret>(
         (static_cast<type*>(object)->t->*(static_cast<type*>(object)->func))(
-            args...));
+            std::forward<impl::param_t<Args>>(args)...));
   }
 
   template <typename Ret, typename... Args>
-  Ret delegate<Ret(Args...)>::null_invoke(void*, Args...) {
+  Ret delegate<Ret(Args...)>::null_invoke(void*, impl::param_t<Args>...) {
     // this function does a null invoke, i.e. does nothing. In case Ret != void
     // and Ret is constructible with no arguments, a statically allocated value
     // of Ret is returned.
     using type = std::remove_cv_t<std::remove_reference_t<Ret>>;
     if constexpr ((!std::is_same_v<Ret, void>)&&std::is_constructible_v<type>) {
-      /// statically allocated variable in case of Ret != void. Ret must be
-      /// constructible with no arguments.
-      static type r{};
-      return r;
+      if constexpr (std::is_reference_v<Ret> ||
+                    std::is_copy_constructible_v<type>) {
+        /// statically allocated variable in case of Ret != void. Ret must be
+        /// constructible with no arguments.
+        static type r{};
+        return r;
+      } else {
+        // move only types, e.g. pc::task, cannot be copied from a static.
+        return type{};
+      }
     }
   }
 
   template <typename Ret, typename... Args>
   template <typename F>
-  Ret delegate<Ret(Args...)>::heap_invoke(void* f, Args... args) {
+  Ret delegate<Ret(Args...)>::heap_invoke(
+      void* f, impl::param_t<Args>... args) {
     // storage will contain a pointer to a heap allocated functor. This means
     // f's correct type is F**.
-    return static_cast<Ret>((*(*static_cast<F**>(f)))(args...));
+    return static_cast<Ret>(
+        (*(*static_cast<F**>(f)))(std::forward<impl::param_t<Args>>(args)...));
+  }
+
+  template <typename Ret, typename... Args>
+  void delegate<Ret(Args...)>::invoke_each(
+      InvokeFuncPtr_t invoke, void* object, size_t n,
+      impl::bulk_element_t<Args>*... args, impl::bulk_result_t<Ret>* out) {
+    for (size_t i = 0; i < n; ++i) {
+      if constexpr (std::is_void_v<Ret>)
+        invoke(object, static_cast<impl::param_t<Args>>(args[i])...);
+      else if constexpr (has_invoke_n)
+        out[i] = invoke(object, static_cast<impl::param_t<Args>>(args[i])...);
+    }
+  }
+
+  template <typename Ret, typename... Args>
+  template <typename F, bool Heap>
+  void delegate<Ret(Args...)>::functor_invoke_n(
+      InvokeFuncPtr_t, void* f, size_t n, impl::bulk_element_t<Args>*... args,
+      impl::bulk_result_t<Ret>* out) {
+    // see inline_invoke and heap_invoke for the type of f.
+    F* functor;
+    if constexpr (Heap)
+      functor = *static_cast<F**>(f);
+    else
+      functor = static_cast<F*>(f);
+    if constexpr (impl::has_bulk_call<F, Ret, Args...>()) {
+      if constexpr (std::is_void_v<Ret>)
+        (*functor)(bulk, span<impl::bulk_element_t<Args>>(args, n)...);
+      else
+        (*functor)(bulk, span<impl::bulk_element_t<Args>>(args, n)...,
+                   span<impl::bulk_result_t<Ret>>(out, n));
+    } else {
+      for (size_t i = 0; i < n; ++i) {
+        if constexpr (std::is_void_v<Ret>)
+          (*functor)(static_cast<impl::param_t<Args>>(args[i])...);
+        else if constexpr (has_invoke_n)
+          out[i] = (*functor)(static_cast<impl::param_t<Args>>(args[i])...);
+      }
+    }
+  }
+
+  template <typename Ret, typename... Args>
+  template <typename F>
+  const impl::vtable* delegate<Ret(Args...)>::inline_table() {
+    // make_inline() falls back to the trivial vtable if it can.
+    const impl::vtable* vtable = impl::vtable::make_inline<F>();
+    static const table_t table{*vtable, &functor_invoke_n<F, false>,
+                               vtable == impl::vtable::make_trivial()
+                                   ? pc::storage_kind::trivial
+                                   : pc::storage_kind::inplace,
+                               type_id::of<F>()};
+    return &table;
   }
 
   template <typename Ret, typename... Args>
   template <typename F>
-  Ret delegate<Ret(Args...)>::inline_invoke(void* f, Args... args) {
+  const impl::vtable* delegate<Ret(Args...)>::heap_table() {
+    static const table_t table{*impl::vtable::make_heap<F>(),
+                               &functor_invoke_n<F, true>,
+                               pc::storage_kind::heap, type_id::of<F>()};
+    return &table;
+  }
+
+  template <typename Ret, typename... Args>
+  template <typename T>
+  const impl::vtable* delegate<Ret(Args...)>::trivial_table() {
+    static const table_t table{*impl::vtable::make_trivial(), &invoke_each,
+                               pc::storage_kind::trivial, type_id::of<T>()};
+    return &table;
+  }
+
+  template <typename Ret, typename... Args>
+  const impl::vtable* delegate<Ret(Args...)>::null_table() {
+    static const table_t table{*impl::vtable::make_null(), &invoke_each,
+                               pc::storage_kind::null, type_id()};
+    return &table;
+  }
+
+  template <typename Ret, typename... Args>
+  template <typename F>
+  Ret delegate<Ret(Args...)>::inline_invoke(
+      void* f, impl::param_t<Args>... args) {
     // storage will contain an instance of f inline -> f's correct type
     // is 'pointer to F'
-    return static_cast<Ret>((*static_cast<F*>(f))(args...));
+    return static_cast<Ret>(
+        (*static_cast<F*>(f))(std::forward<impl::param_t<Args>>(args)...));
   }
 
   template <typename T>
@@ -656,6 +1608,21 @@ namespace pc {
     std::memcpy(dest, &t, sizeof(T*));
   }
 
+  template <typename T>
+  bool impl::vtable::heap_try_copy(void* dest, const void* source) {
+    T* t = new (std::nothrow) T(*(*static_cast<const T* const*>(source)));
+    if (t == nullptr)
+      return false;
+    std::memcpy(dest, &t, sizeof(T*));
+    return true;
+  }
+
+  template <void (*Copy)(void*, const void*)>
+  bool impl::vtable::infallible_copy(void* dest, const void* source) {
+    Copy(dest, source);
+    return true;
+  }
+
   template <typename T>
   void impl::vtable::heap_move(void* dest, void* source) {
     // when moving a delegate, whe dont actually have to move the callable. we
@@ -680,6 +1647,8 @@ namespace pc {
       return impl::vtable::make_trivial();
     }
     static const impl::vtable impl{&vtable::inline_copy<T>,
+                                   &vtable::infallible_copy<
+                                       &vtable::inline_copy<T>>,
                                    &vtable::inline_move<T>,
                                    &vtable::inline_destroy<T>};
     return &impl;
@@ -688,6 +1657,7 @@ namespace pc {
   template <typename T>
   const impl::vtable* impl::vtable::make_heap() {
     static const impl::vtable impl{&impl::vtable::heap_copy<T>,
+                                   &impl::vtable::heap_try_copy<T>,
                                    &impl::vtable::trivial_move,
                                    &impl::vtable::heap_destroy<T>};
     return &impl;
@@ -695,6 +1665,8 @@ namespace pc {
 
   inline const impl::vtable* impl::vtable::make_trivial() {
     static const impl::vtable impl{&impl::vtable::trivial_copy,
+                                   &impl::vtable::infallible_copy<
+                                       &impl::vtable::trivial_copy>,
                                    &impl::vtable::trivial_move,
                                    &impl::vtable::null_destroy};
     return &impl;
@@ -702,6 +1674,8 @@ namespace pc {
 
   inline const impl::vtable* impl::vtable::make_null() {
     static const impl::vtable impl{&impl::vtable::null_copy,
+                                   &impl::vtable::infallible_copy<
+                                       &impl::vtable::null_copy>,
                                    &impl::vtable::null_move,
                                    &impl::vtable::null_destroy};
     return &impl;
@@ -0,0 +1,334 @@
+/**
+ * \file event_bus.hpp
+ * \author Pele Constam (pelectron1602\gmail.com)
+ * \brief This file defines the \ref pc::event_bus<Events...> class, a set of
+ * multicast_delegate channels indexed by compile time event ids.
+ * \version 0.1
+ * \date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef PC_EVENT_BUS_HPP
+#define PC_EVENT_BUS_HPP
+#include "multicast_delegate.hpp"
+
+#include <algorithm>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace pc {
+  /**
+   * \brief convenience base for event types.
+   * \code{.cpp}
+   * struct key_pressed : pc::event<0, void(int key)> {};
+   * \endcode
+   * \tparam Id id of the event, see \ref pc::event_bus<Events...>
+   * \tparam Signature signature of the event's channel, of the form
+   * Ret(Args...)
+   */
+  template <size_t Id, typename Signature>
+  struct event {
+    /// id of the event.
+    static constexpr size_t id = Id;
+    /// signature of the event's channel.
+    using signature = Signature;
+  };
+
+  namespace impl {
+    /**
+     * \brief the channels of an event_bus, stored in a table of equally sized
+     * slots. The slot of an event is its id, i.e. accessing a channel is an
+     * array index.
+     *
+     * This class does not depend on the event types, only on their number and
+     * the slot layout. This keeps the names of the per event member function
+     * instantiations short, which matters for buses with thousands of events.
+     *
+     * \tparam NumEvents number of slots
+     * \tparam SlotSize size of a slot, i.e. of the largest channel
+     * \tparam SlotAlign alignment of a slot, i.e. of the most aligned channel
+     */
+    template <size_t NumEvents, size_t SlotSize, size_t SlotAlign>
+    class event_table {
+    public:
+      /// channel type of Event.
+      template <typename Event>
+      using channel_t = multicast_delegate<typename Event::signature>;
+
+      /// get the number of event types.
+      static constexpr size_t num_events() { return NumEvents; }
+
+      /// get the index of Event's channel, i.e. its id.
+      template <typename Event>
+      static constexpr size_t index_of() {
+        static_assert(Event::id < NumEvents, "Event is not an event of this "
+                                             "event_bus.");
+        return Event::id;
+      }
+
+      /**
+       * \brief get the channel of Event. Use it to access the results or any
+       * other multicast_delegate functionality.
+       * \tparam Event event type
+       * \return channel_t<Event>& the channel
+       */
+      template <typename Event>
+      channel_t<Event>& channel();
+
+      /// const overload of channel().
+      template <typename Event>
+      const channel_t<Event>& channel() const;
+
+      /**
+       * \brief bind a callable to the channel of Event.
+       * \tparam Event event type
+       * \param bind_args arguments to bind, see multicast_delegate::bind().
+       * \return the subscription id, see multicast_delegate::unbind().
+       */
+      template <typename Event, typename... BindArgs>
+      auto subscribe(BindArgs&&... bind_args);
+
+      /**
+       * \brief unbind a callable from the channel of Event.
+       * \tparam Event event type
+       * \param id id returned by subscribe()
+       * \return true the callable was unbound
+       * \return false no callable with this id is bound to the channel
+       */
+      template <typename Event>
+      bool unsubscribe(typename channel_t<Event>::subscription_id id);
+
+      /**
+       * \brief invoke the channel of Event.
+       * \tparam Event event type
+       * \param args arguments, converted to the arguments of Event's
+       * signature.
+       */
+      template <typename Event, typename... PublishArgs>
+      void publish(PublishArgs&&... args);
+
+    protected:
+      event_table() = default;
+      ~event_table() = default;
+
+      /// construct the channel of Event in its slot.
+      template <typename Event>
+      void construct() {
+        static_assert(sizeof(channel_t<Event>) <= SlotSize &&
+                          alignof(channel_t<Event>) <= SlotAlign,
+                      "Something wrong in the implementation. The channel does "
+                      "not fit into its slot.");
+        ::new (static_cast<void*>(&slots[index_of<Event>()]))
+            channel_t<Event>();
+      }
+
+      /// destroy the channel of Event.
+      template <typename Event>
+      void destroy() {
+        using channel_type = channel_t<Event>;
+        channel<Event>().~channel_type();
+      }
+
+    private:
+      struct alignas(SlotAlign) slot {
+        unsigned char bytes[SlotSize];
+      };
+
+      slot slots[NumEvents];
+    };
+
+    /// channel type of Event.
+    template <typename Event>
+    using event_channel_t = multicast_delegate<typename Event::signature>;
+
+    /// size of the largest channel of Events.
+    template <typename... Events>
+    constexpr size_t max_channel_size() {
+      return std::max({size_t{1}, sizeof(event_channel_t<Events>)...});
+    }
+
+    /// alignment of the most aligned channel of Events.
+    template <typename... Events>
+    constexpr size_t max_channel_align() {
+      return std::max({alignof(char), alignof(event_channel_t<Events>)...});
+    }
+
+    /// marks T as an element of a set of types, see type_set.
+    template <typename T>
+    struct type_tag {};
+
+    /// a set of types. Membership is a base class lookup, which compilers do
+    /// without instantiating anything per element.
+    template <typename... Ts>
+    struct type_set : type_tag<Ts>... {};
+
+    /// checks that the ids are exactly the numbers 0 to sizeof...(Ids) - 1.
+    template <size_t... Ids>
+    constexpr bool are_dense_ids() {
+      constexpr size_t n = sizeof...(Ids);
+      const size_t     ids[n + 1] = {Ids..., 0};
+      bool             seen[n + 1] = {};
+      for (size_t i = 0; i < n; ++i) {
+        if (ids[i] >= n || seen[ids[i]])
+          return false;
+        seen[ids[i]] = true;
+      }
+      return true;
+    }
+
+    template <size_t NumEvents, size_t SlotSize, size_t SlotAlign>
+    template <typename Event>
+    typename event_table<NumEvents, SlotSize,
+                         SlotAlign>::template channel_t<Event>&
+        event_table<NumEvents, SlotSize, SlotAlign>::channel() {
+      return *std::launder(
+          reinterpret_cast<channel_t<Event>*>(&slots[index_of<Event>()]));
+    }
+
+    template <size_t NumEvents, size_t SlotSize, size_t SlotAlign>
+    template <typename Event>
+    const typename event_table<NumEvents, SlotSize,
+                               SlotAlign>::template channel_t<Event>&
+        event_table<NumEvents, SlotSize, SlotAlign>::channel() const {
+      return *std::launder(reinterpret_cast<const channel_t<Event>*>(
+          &slots[index_of<Event>()]));
+    }
+
+    template <size_t NumEvents, size_t SlotSize, size_t SlotAlign>
+    template <typename Event, typename... BindArgs>
+    auto event_table<NumEvents, SlotSize, SlotAlign>::subscribe(
+        BindArgs&&... bind_args) {
+      return channel<Event>().bind(std::forward<BindArgs>(bind_args)...);
+    }
+
+    template <size_t NumEvents, size_t SlotSize, size_t SlotAlign>
+    template <typename Event>
+    bool event_table<NumEvents, SlotSize, SlotAlign>::unsubscribe(
+        typename channel_t<Event>::subscription_id id) {
+      return channel<Event>().unbind(id);
+    }
+
+    template <size_t NumEvents, size_t SlotSize, size_t SlotAlign>
+    template <typename Event, typename... PublishArgs>
+    void event_table<NumEvents, SlotSize, SlotAlign>::publish(
+        PublishArgs&&... args) {
+      channel<Event>()(std::forward<PublishArgs>(args)...);
+    }
+  } // namespace impl
+
+  /**
+   * \brief \anchor event-bus-brief a collection of multicast_delegate channels,
+   * one per event type.
+   *
+   * Each event is declared as a type, which provides a signature alias and an
+   * id. The ids of the events of a bus must be the numbers 0 to
+   * sizeof...(Events) - 1 in any order. The easiest way to declare an event is
+   * to derive from \ref pc::event<Id, Signature>:
+   * \code{.cpp}
+   * struct key_pressed : pc::event<0, void(int key)> {};
+   * struct resized : pc::event<1, void(int width, int height)> {};
+   * pc::event_bus<key_pressed, resized> bus;
+   * bus.subscribe<resized>([](int w, int h) { ... });
+   * bus.publish<resized>(640, 480);
+   * \endcode
+   *
+   * The channels are stored in a table indexed by the event id, i.e. publishing
+   * an event does not hash or search anything at run time. It is an array index
+   * with a compile time constant, followed by the invocation of the channel.
+   *
+   * An event_bus is neither copyable nor movable. Accessing the channel of an
+   * event type which is not one of Events does not compile, even if its id is
+   * in range.
+   *
+   * \tparam Events event types. Each must define a signature alias of the form
+   * Ret(Args...) and a static constexpr size_t id.
+   */
+  template <typename... Events>
+  class event_bus
+      : public impl::event_table<sizeof...(Events),
+                                 impl::max_channel_size<Events...>(),
+                                 impl::max_channel_align<Events...>()> {
+    using table_t = impl::event_table<sizeof...(Events),
+                                      impl::max_channel_size<Events...>(),
+                                      impl::max_channel_align<Events...>()>;
+
+    static_assert(sizeof...(Events) > 0,
+                  "an event_bus needs at least one event.");
+    static_assert(impl::are_dense_ids<Events::id...>(),
+                  "the event ids must be the numbers 0 to sizeof...(Events) - "
+                  "1, each used exactly once.");
+
+  public:
+    /// default constructor, all channels are empty.
+    event_bus() {
+      // the channels are constructed by expanding the events into an array
+      // rather than with a fold expression, which compilers nest and handle in
+      // quadratic time for thousands of events.
+      const bool constructed[] = {
+          (this->template construct<Events>(), true)...};
+      (void)constructed;
+    }
+    event_bus(const event_bus&) = delete;
+    event_bus& operator=(const event_bus&) = delete;
+    /// destructor
+    ~event_bus() {
+      const bool destroyed[] = {(this->template destroy<Events>(), true)...};
+      (void)destroyed;
+    }
+
+    // the members below check that Event is one of Events before forwarding to
+    // the event_table, which only knows the number of events.
+
+    /// \copydoc impl::event_table::channel()
+    template <typename Event>
+    typename table_t::template channel_t<Event>& channel() {
+      check<Event>();
+      return table_t::template channel<Event>();
+    }
+
+    /// const overload of channel().
+    template <typename Event>
+    const typename table_t::template channel_t<Event>& channel() const {
+      check<Event>();
+      return table_t::template channel<Event>();
+    }
+
+    /// \copydoc impl::event_table::subscribe()
+    template <typename Event, typename... BindArgs>
+    auto subscribe(BindArgs&&... bind_args) {
+      check<Event>();
+      return table_t::template subscribe<Event>(
+          std::forward<BindArgs>(bind_args)...);
+    }
+
+    /// \copydoc impl::event_table::unsubscribe()
+    template <typename Event>
+    bool unsubscribe(
+        typename table_t::template channel_t<Event>::subscription_id id) {
+      check<Event>();
+      return table_t::template unsubscribe<Event>(id);
+    }
+
+    /// \copydoc impl::event_table::publish()
+    template <typename Event, typename... PublishArgs>
+    void publish(PublishArgs&&... args) {
+      check<Event>();
+      table_t::template publish<Event>(std::forward<PublishArgs>(args)...);
+    }
+
+  private:
+    /// fails to compile if Event is not one of Events.
+    template <typename Event>
+    static constexpr void check() {
+      static_assert(std::is_base_of_v<impl::type_tag<Event>,
+                                      impl::type_set<Events...>>,
+                    "Event is not an event of this event_bus.");
+    }
+  };
+} // namespace pc
+
+#endif
@@ -0,0 +1,349 @@
+/**
+ * \file event_loop.hpp
+ * \author Pele Constam (pelectron1602\gmail.com)
+ * \brief This file defines the \ref pc::event_loop class, an epoll based event
+ * loop dispatching file descriptor readiness to delegates. Linux only.
+ * \version 0.1
+ * \date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef PC_EVENT_LOOP_HPP
+#define PC_EVENT_LOOP_HPP
+#include "delegate.hpp"
+
+#ifdef __linux__
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <iterator>
+#include <mutex>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace pc {
+  /**
+   * \brief \anchor event-loop-brief an event loop which invokes a
+   * delegate<void(int, uint32_t)> per file descriptor when epoll reports it
+   * ready, and runs delegate<void()> tasks posted from any thread.
+   *
+   * The handlers are stored in a std::deque indexed by file descriptor, so
+   * they keep their address when the deque grows, and the readiness events of
+   * one epoll_wait() call are dispatched as a batch from a buffer allocated by
+   * the constructor. Dispatching an event therefore does not allocate. The
+   * epoll data of a file descriptor contains a generation count, which skips
+   * events still in the batch for a file descriptor that was removed in the
+   * meantime.
+   *
+   * Tasks are posted to a mutex guarded vector and the loop is woken through
+   * an eventfd, which is only written if the vector was empty. The loop swaps
+   * the vector with a second one and runs the tasks from there, so the
+   * vectors keep their capacity and posting only allocates while they grow.
+   *
+   * Handlers may add, modify and remove file descriptors, including their own.
+   * A handler removing or replacing itself is destroyed after it returns.
+   * Errors of the system calls are reported as std::system_error. Without
+   * exceptions, see [PC_DELEGATE_NO_EXCEPTIONS](#PC_DELEGATE_NO_EXCEPTIONS),
+   * they are printed to stderr and abort the program.
+   */
+  class event_loop {
+  public:
+    /// handler type, called with the file descriptor and the epoll events.
+    using handler_t = delegate<void(int, uint32_t)>;
+    /// task type.
+    using task_t = delegate<void()>;
+
+    /**
+     * \brief create the epoll instance and the wakeup eventfd.
+     * \param max_events maximum number of events dispatched per epoll_wait()
+     */
+    explicit event_loop(size_t max_events = 256);
+    event_loop(const event_loop&) = delete;
+    event_loop& operator=(const event_loop&) = delete;
+    /// destructor. Closes the epoll instance and the eventfd, but not the
+    /// added file descriptors. Posted tasks which did not run are discarded.
+    ~event_loop();
+
+    /**
+     * \brief watch fd for events and call handler when it is ready.
+     * \tparam F callable type, must be bindable to a handler_t.
+     * \param fd file descriptor, must not be watched already
+     * \param events epoll events, e.g. EPOLLIN | EPOLLET
+     * \param handler callable
+     */
+    template <typename F>
+    void add(int fd, uint32_t events, F&& handler);
+
+    /// change the events fd is watched for.
+    void modify(int fd, uint32_t events);
+
+    /// stop watching fd. Events for fd which are not dispatched yet are
+    /// dropped.
+    void remove(int fd);
+
+    /**
+     * \brief run task on the loop's thread. Thread safe.
+     * \param task task to run
+     */
+    void post(task_t task);
+
+    /**
+     * \brief wait for events once and dispatch them, then run the posted
+     * tasks. If a handler throws, the exception propagates and the next call
+     * dispatches the rest of the batch and runs the tasks without waiting.
+     * \param timeout_ms timeout of epoll_wait(), -1 waits indefinitely
+     * \return size_t number of handlers and tasks invoked
+     */
+    size_t run_once(int timeout_ms = -1);
+
+    /// call run_once() until stop() is called.
+    void run();
+
+    /// make run() return after the current batch. Thread safe.
+    void stop();
+
+  private:
+    /// a watched file descriptor.
+    struct slot {
+      handler_t handler;
+      handler_t replacement; //< installed after the handler returns
+      uint32_t  generation{0};
+      bool      watched{false};
+      bool      replace{false}; //< install replacement after the handler
+    };
+
+    /// run the posted tasks.
+    size_t run_tasks();
+    /// make epoll_wait() return by writing to the eventfd.
+    void wake();
+    /// get the slot of fd, growing the slots if needed.
+    slot& slot_of(int fd);
+    /// epoll_ctl() throwing on error.
+    void control(int op, int fd, uint32_t events, uint32_t generation);
+    [[noreturn]] static void throw_errno(const char* what);
+    /// report error, or abort without exceptions.
+    [[noreturn]] static void throw_error(int error, const char* what);
+
+    int                      epoll_fd{-1};
+    int                      wakeup_fd{-1};
+    std::vector<epoll_event> events;
+    size_t                   next_event{0}; //< next event of the batch
+    size_t                   num_events{0}; //< events in the batch
+    bool                     dispatching{false}; //< batch not finished
+    std::deque<slot>         slots;
+    int                      running_fd{-1}; //< fd whose handler is running
+    std::mutex               task_mutex;
+    std::vector<task_t>      posted;
+    std::vector<task_t>      running;
+    std::atomic<bool>        stopping{false};
+  };
+
+  inline event_loop::event_loop(size_t max_events)
+      : events(max_events == 0 ? 1 : max_events) {
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0)
+      throw_errno("epoll_create1");
+    wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeup_fd < 0) {
+      const int error = errno;
+      close(epoll_fd);
+      throw_error(error, "eventfd");
+    }
+    epoll_event e{};
+    e.events = EPOLLIN;
+    e.data.u64 = static_cast<uint32_t>(wakeup_fd);
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wakeup_fd, &e) != 0) {
+      const int error = errno;
+      close(wakeup_fd);
+      close(epoll_fd);
+      throw_error(error, "epoll_ctl");
+    }
+  }
+
+  inline event_loop::~event_loop() {
+    close(wakeup_fd);
+    close(epoll_fd);
+  }
+
+  template <typename F>
+  void event_loop::add(int fd, uint32_t events, F&& handler) {
+    slot& s = slot_of(fd);
+    control(EPOLL_CTL_ADD, fd, events, s.generation);
+    s.watched = true;
+    if (fd == running_fd) {
+      // the running handler is replaced once it returns.
+      s.replacement.bind(std::forward<F>(handler));
+      s.replace = true;
+    } else {
+      s.handler.bind(std::forward<F>(handler));
+    }
+  }
+
+  inline void event_loop::modify(int fd, uint32_t events) {
+    control(EPOLL_CTL_MOD, fd, events, slot_of(fd).generation);
+  }
+
+  inline void event_loop::remove(int fd) {
+    slot& s = slot_of(fd);
+    control(EPOLL_CTL_DEL, fd, 0, s.generation);
+    s.watched = false;
+    ++s.generation;
+    if (fd == running_fd) {
+      s.replacement.reset();
+      s.replace = true;
+    } else {
+      s.handler.reset();
+    }
+  }
+
+  inline void event_loop::post(task_t task) {
+    bool was_empty;
+    {
+      std::lock_guard<std::mutex> lock(task_mutex);
+      was_empty = posted.empty();
+      posted.push_back(std::move(task));
+    }
+    // the loop reads the eventfd before it takes the posted tasks, so only
+    // the first task of a batch needs to wake it.
+    if (was_empty)
+      wake();
+  }
+
+  inline size_t event_loop::run_once(int timeout_ms) {
+    // dispatching is still set if a handler threw in the previous call. The
+    // rest of its batch is dispatched before waiting again, edge triggered
+    // events would not be reported again.
+    if (!dispatching) {
+      const int n = epoll_wait(epoll_fd, events.data(),
+                               static_cast<int>(events.size()), timeout_ms);
+      if (n < 0) {
+        if (errno == EINTR)
+          return 0;
+        throw_errno("epoll_wait");
+      }
+      next_event = 0;
+      num_events = static_cast<size_t>(n);
+      dispatching = true;
+    }
+    size_t invoked = 0;
+    while (next_event < num_events) {
+      const epoll_event& e = events[next_event++];
+      const uint64_t     data = e.data.u64;
+      const int          fd = static_cast<int>(static_cast<uint32_t>(data));
+      if (fd == wakeup_fd) {
+        uint64_t count;
+        (void)!read(wakeup_fd, &count, sizeof(count));
+        continue;
+      }
+      slot& s = slots[static_cast<size_t>(fd)];
+      if (!s.watched || s.generation != static_cast<uint32_t>(data >> 32))
+        continue; // removed by an earlier handler of this batch
+      // install a replacement even if the handler throws.
+      struct running_guard {
+        event_loop& loop;
+        slot&       s;
+        ~running_guard() {
+          loop.running_fd = -1;
+          if (s.replace) {
+            s.handler = std::move(s.replacement);
+            s.replace = false;
+          }
+        }
+      } guard{*this, s};
+      running_fd = fd;
+      s.handler(fd, e.events);
+      ++invoked;
+    }
+    dispatching = false;
+    return invoked + run_tasks();
+  }
+
+  inline void event_loop::run() {
+    while (!stopping.load(std::memory_order_acquire))
+      run_once();
+    stopping.store(false, std::memory_order_relaxed);
+  }
+
+  inline void event_loop::stop() {
+    stopping.store(true, std::memory_order_release);
+    wake();
+  }
+
+  inline void event_loop::wake() {
+    const uint64_t one = 1;
+    (void)!write(wakeup_fd, &one, sizeof(one));
+  }
+
+  inline size_t event_loop::run_tasks() {
+    {
+      std::lock_guard<std::mutex> lock(task_mutex);
+      running.swap(posted);
+    }
+    // clear running even if a task throws. The tasks after it are posted again
+    // ahead of those posted meanwhile, so that none runs twice or is lost.
+    struct tasks_guard {
+      event_loop& loop;
+      size_t      next{0}; //< index of the next task to run
+      ~tasks_guard() {
+        if (next < loop.running.size()) {
+          std::lock_guard<std::mutex> lock(loop.task_mutex);
+          loop.posted.insert(
+              loop.posted.begin(),
+              std::make_move_iterator(loop.running.begin() + next),
+              std::make_move_iterator(loop.running.end()));
+          loop.wake();
+        }
+        loop.running.clear();
+      }
+    } guard{*this};
+    while (guard.next < running.size())
+      running[guard.next++]();
+    return running.size();
+  }
+
+  inline event_loop::slot& event_loop::slot_of(int fd) {
+    if (fd < 0)
+      throw_error(EBADF, "event_loop");
+    if (static_cast<size_t>(fd) >= slots.size())
+      slots.resize(static_cast<size_t>(fd) + 1);
+    return slots[static_cast<size_t>(fd)];
+  }
+
+  inline void event_loop::control(int op, int fd, uint32_t events,
+                                  uint32_t generation) {
+    epoll_event e{};
+    e.events = events;
+    e.data.u64 = (static_cast<uint64_t>(generation) << 32) |
+                 static_cast<uint32_t>(fd);
+    if (epoll_ctl(epoll_fd, op, fd, &e) != 0)
+      throw_errno("epoll_ctl");
+  }
+
+  inline void event_loop::throw_errno(const char* what) {
+    throw_error(errno, what);
+  }
+
+  inline void event_loop::throw_error(int error, const char* what) {
+#ifdef PC_DELEGATE_NO_EXCEPTIONS
+    std::fprintf(stderr, "%s: %s\n", what,
+                 std::generic_category().message(error).c_str());
+    std::abort();
+#else
+    throw std::system_error(error, std::generic_category(), what);
+#endif
+  }
+} // namespace pc
+
+#endif
+#endif
@@ -0,0 +1,544 @@
+/**
+ * \file future.hpp
+ * \author Pele Constam (pelectron1602\gmail.com)
+ * \brief This file defines the \ref pc::future<Ret> class returned by
+ * delegate::invoke_async() and multicast_delegate::invoke_async(), and
+ * \ref pc::when_all().
+ * \version 0.1
+ * \date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef PC_FUTURE_HPP
+#define PC_FUTURE_HPP
+#include "delegate.hpp"
+#include "multicast_delegate.hpp"
+
+#include <algorithm>
+#include <atomic>
+#ifndef PC_DELEGATE_NO_EXCEPTIONS
+#include <exception>
+#endif
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace pc {
+  namespace impl {
+    /**
+     * \brief a process wide free list of T. Used for the shared states of
+     * futures, so that starting an asynchronous call only allocates when no
+     * state of the same type is free.
+     *
+     * Each thread keeps a small cache of free objects in front of the shared
+     * list, so acquire() and release() usually do not touch the shared mutex.
+     * Objects move between a cache and the shared list in batches: a thread
+     * which mostly releases, like a worker finishing calls, hands them back
+     * once its cache is full, and a thread which mostly acquires refills its
+     * cache from the shared list once it is empty. A thread's cache is handed
+     * back when the thread exits.
+     * \tparam T pooled type, must be default constructible.
+     */
+    template <typename T>
+    class object_pool {
+    public:
+      /// get a free object, or a new one if there is none.
+      static T* acquire() {
+        std::vector<T*>& cache = local_cache().objects;
+        if (cache.empty())
+          instance().take(cache);
+        if (cache.empty())
+          return new T();
+        T* t = cache.back();
+        cache.pop_back();
+        return t;
+      }
+
+      /// give an object back to the pool.
+      static void release(T* t) {
+        std::vector<T*>& cache = local_cache().objects;
+        cache.push_back(t);
+        if (cache.size() >= 2 * batch_size)
+          instance().give(cache, batch_size);
+      }
+
+    private:
+      /// number of objects moved between a cache and the shared list at once.
+      static constexpr size_t batch_size = 32;
+
+      /// the free objects of a thread.
+      struct thread_cache {
+        thread_cache() { objects.reserve(2 * batch_size); }
+        ~thread_cache() { instance().give(objects, objects.size()); }
+        std::vector<T*> objects;
+      };
+
+      ~object_pool() {
+        for (T* t : free)
+          delete t;
+      }
+
+      static object_pool& instance() {
+        static object_pool pool;
+        return pool;
+      }
+
+      static thread_cache& local_cache() {
+        thread_local thread_cache cache;
+        return cache;
+      }
+
+      /// move up to batch_size objects from the shared list to cache.
+      void take(std::vector<T*>& cache) {
+        std::lock_guard<std::mutex> lock(mutex);
+        const size_t n = std::min(batch_size, free.size());
+        cache.insert(cache.end(), free.end() - n, free.end());
+        free.resize(free.size() - n);
+      }
+
+      /// move the last n objects of cache to the shared list.
+      void give(std::vector<T*>& cache, size_t n) {
+        std::lock_guard<std::mutex> lock(mutex);
+        free.insert(free.end(), cache.end() - n, cache.end());
+        cache.resize(cache.size() - n);
+      }
+
+      std::mutex      mutex;
+      std::vector<T*> free;
+    };
+
+    /// the value of a future_state. Empty for Ret = void.
+    template <typename Ret>
+    struct future_value {
+      std::optional<ret_val_t<Ret>> value;
+    };
+
+    /// specialization for Ret = void.
+    template <>
+    struct future_value<void> {};
+
+    /**
+     * \brief the state shared by a future and the producer of its value.
+     *
+     * Both sides hold a reference and call release() when done with the
+     * state; the last one hands it back to its pool through recycle. The
+     * status goes from pending to has_continuation if a continuation is set
+     * first, and to ready once the value is set. Whichever of the two comes
+     * second runs the continuation. If the producer threw instead of
+     * providing a value, exception holds what it threw, and the state is
+     * ready without a value.
+     */
+    template <typename Ret>
+    struct future_state : future_value<Ret> {
+      /// status values.
+      enum : int { pending, has_continuation, ready };
+
+      /// prepare a recycled state for a new value.
+      void reset(void (*recycle_func)(future_state*)) {
+        status.store(pending, std::memory_order_relaxed);
+        refs.store(2, std::memory_order_relaxed);
+        if constexpr (!std::is_same_v<Ret, void>)
+          this->value.reset();
+        continuation.reset();
+#ifndef PC_DELEGATE_NO_EXCEPTIONS
+        exception = nullptr;
+#endif
+        recycle = recycle_func;
+      }
+
+      /// checks if the producer threw instead of providing a value.
+      bool failed() const {
+#ifdef PC_DELEGATE_NO_EXCEPTIONS
+        return false;
+#else
+        return exception != nullptr;
+#endif
+      }
+
+      /// rethrow the exception thrown by the producer, if any.
+      void rethrow_if_failed() const {
+#ifndef PC_DELEGATE_NO_EXCEPTIONS
+        if (exception)
+          std::rethrow_exception(exception);
+#endif
+      }
+
+      /// mark the value as set and run the continuation, if any.
+      void set_ready() {
+        if (status.exchange(ready, std::memory_order_acq_rel) ==
+            has_continuation)
+          continuation();
+      }
+
+      /// run c once the value is set. Runs c right away if it is set already.
+      void set_continuation(delegate<void()> c) {
+        continuation = std::move(c);
+        int expected = pending;
+        if (!status.compare_exchange_strong(expected, has_continuation,
+                                            std::memory_order_acq_rel))
+          continuation();
+      }
+
+      /// checks if the value is set.
+      bool is_ready() const {
+        return status.load(std::memory_order_acquire) == ready;
+      }
+
+      /// drop a reference. Recycles the state if it was the last one.
+      void release() {
+        if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+          recycle(this);
+      }
+
+      std::atomic<int> status{pending};
+      std::atomic<int> refs{2};
+      delegate<void()> continuation;
+#ifndef PC_DELEGATE_NO_EXCEPTIONS
+      std::exception_ptr exception; //< thrown by the producer
+#endif
+      void (*recycle)(future_state*){nullptr};
+    };
+
+    /// drops a reference to a future_state when it goes out of scope, even if
+    /// a continuation throws.
+    template <typename Ret>
+    struct state_release_guard {
+      future_state<Ret>* state;
+      ~state_release_guard() { state->release(); }
+    };
+
+    /// hands a state of type T back to its pool.
+    template <typename T, typename Ret>
+    void recycle_state(future_state<Ret>* state) {
+      object_pool<T>::release(static_cast<T*>(state));
+    }
+
+    /**
+     * \brief the state of a delegate::invoke_async() call. Holds the
+     * arguments until the delegate has been invoked.
+     */
+    template <typename Ret, typename... Args>
+    struct async_call : future_state<Ret> {
+      /// invoke d with args on executor.
+      template <typename Executor>
+      static future<Ret> start(Executor&                executor,
+                               delegate<Ret(Args...)>& d, Args... args);
+
+      /// invoke the delegate and set the value, or the exception it throws.
+      void run();
+
+      /// invoke the delegate and set the value.
+      void invoke();
+
+      delegate<Ret(Args...)>*                        del{nullptr};
+      std::optional<std::tuple<std::decay_t<Args>...>> args;
+    };
+
+    /**
+     * \brief the state of a when_all() call. Holds the input futures until
+     * all of them are ready.
+     */
+    template <typename Ret>
+    struct when_all_state : future_state<when_all_t<Ret>> {
+      /// get a state from the pool. Push the inputs to inputs, then call
+      /// arm().
+      static when_all_state* make();
+
+      /// start waiting for the inputs.
+      future<when_all_t<Ret>> arm();
+
+      /// called when one input is ready.
+      void input_ready();
+
+      std::vector<future<Ret>> inputs;
+      std::atomic<size_t>      remaining{0};
+    };
+  } // namespace impl
+
+  /**
+   * \brief \anchor future-brief the result of an asynchronous invocation.
+   *
+   * A future refers to a shared state which is recycled through a pool
+   * rather than allocated per call like the shared state of a std::promise.
+   * The value is either retrieved with get(), which waits until it is ready,
+   * or passed to a callback registered with then(), which runs on the thread
+   * which sets the value.
+   *
+   * If the invoked callable throws, the exception is stored in the shared
+   * state instead of a value. get() rethrows it, and then() passes it to the
+   * error callback, so that it never propagates out of the thread which sets
+   * the value. Without exceptions, see
+   * [PC_DELEGATE_NO_EXCEPTIONS](#PC_DELEGATE_NO_EXCEPTIONS), nothing is
+   * caught.
+   *
+   * Futures are move only. A default constructed or moved from future is
+   * invalid.
+   *
+   * \tparam Ret value type. For reference types, get() returns the
+   * reference.
+   */
+  template <typename Ret>
+  class future {
+  public:
+    /// default constructor, creates an invalid future.
+    future() = default;
+    /// construct from a shared state. Takes over one reference.
+    explicit future(impl::future_state<Ret>* state) : state(state) {}
+    future(const future&) = delete;
+    future& operator=(const future&) = delete;
+    /// move constructor
+    future(future&& other) noexcept : state(other.state) {
+      other.state = nullptr;
+    }
+    /// move assignment operator
+    future& operator=(future&& other) noexcept {
+      std::swap(state, other.state);
+      return *this;
+    }
+    /// destructor
+    ~future() {
+      if (state != nullptr)
+        state->release();
+    }
+
+    /// checks if the future refers to a shared state.
+    bool valid() const { return state != nullptr; }
+
+    /// checks if the value is ready. The future must be valid.
+    bool is_ready() const { return state->is_ready(); }
+
+    /// wait until the value is ready, yielding the thread in between.
+    void wait() const {
+      while (!is_ready())
+        std::this_thread::yield();
+    }
+
+    /**
+     * \brief wait until the value is ready, running tasks of the executor in
+     * between. Use this if the waiting thread may be one of the executor's.
+     * \param executor executor the value is produced on
+     */
+    template <typename Executor>
+    void wait(Executor& executor) const {
+      while (!is_ready()) {
+        if (!executor.try_run_one())
+          std::this_thread::yield();
+      }
+    }
+
+    /**
+     * \brief wait for the value and get it. The value is moved out of the
+     * shared state, i.e. get() can only be called once.
+     * \return Ret the value
+     * \throws the exception thrown by the invoked callable, if any.
+     */
+    Ret get() {
+      wait();
+      state->rethrow_if_failed();
+      if constexpr (!std::is_same_v<Ret, void>)
+        return static_cast<Ret>(std::move(*state->value));
+    }
+
+    /**
+     * \brief call f with the value once it is ready, on the thread which sets
+     * the value, or right away if it is ready already. Invalidates this
+     * future.
+     * \param f callable with signature void(Ret), or void() for Ret = void.
+     * \note If the invoked callable threw, f is not called and the exception
+     * is discarded. Use the overload taking an error callback to observe it.
+     */
+    template <typename F>
+    void then(F&& f) {
+      auto* s = std::exchange(state, nullptr);
+      s->set_continuation(
+          delegate<void()>([s, f = std::forward<F>(f)]() mutable {
+            // f lives in the state, which may be reused once released.
+            auto                           func = std::move(f);
+            impl::state_release_guard<Ret> guard{s};
+            if (!s->failed())
+              deliver(s, func);
+          }));
+    }
+
+    /**
+     * \brief like then(F&&), but call on_error with the exception if the
+     * invoked callable threw.
+     * \param f callable with signature void(Ret), or void() for Ret = void.
+     * \param on_error callable with signature void(std::exception_ptr). Never
+     * called without exceptions.
+     */
+    template <typename F, typename E>
+    void then(F&& f, E&& on_error) {
+      auto* s = std::exchange(state, nullptr);
+      s->set_continuation(delegate<void()>(
+          [s, f = std::forward<F>(f),
+           on_error = std::forward<E>(on_error)]() mutable {
+            auto                           func = std::move(f);
+            auto                           handler = std::move(on_error);
+            impl::state_release_guard<Ret> guard{s};
+#ifndef PC_DELEGATE_NO_EXCEPTIONS
+            if (s->exception) {
+              handler(s->exception);
+              return;
+            }
+#endif
+            deliver(s, func);
+          }));
+    }
+
+  private:
+    template <typename>
+    friend struct impl::when_all_state;
+
+    /// call func with the value of the ready state s.
+    template <typename F>
+    static void deliver(impl::future_state<Ret>* s, F& func) {
+      if constexpr (std::is_same_v<Ret, void>)
+        func();
+      else
+        func(static_cast<Ret>(std::move(*s->value)));
+    }
+
+    impl::future_state<Ret>* state{nullptr};
+  };
+
+  /**
+   * \brief combine futures into one, which is ready once all of them are.
+   * \param futures the futures to wait for
+   * \return future<std::vector<ret_val_t<Ret>>> the values, in the order of
+   * futures, or future<void> for Ret = void.
+   */
+  template <typename Ret>
+  future<impl::when_all_t<Ret>> when_all(std::vector<future<Ret>> futures) {
+    auto* state = impl::when_all_state<Ret>::make();
+    for (auto& f : futures)
+      state->inputs.push_back(std::move(f));
+    return state->arm();
+  }
+
+  template <typename Ret, typename... Args>
+  template <typename Executor>
+  future<Ret> impl::async_call<Ret, Args...>::start(Executor& executor,
+                                                    delegate<Ret(Args...)>& d,
+                                                    Args... args) {
+    auto* call = object_pool<async_call>::acquire();
+    call->reset(&recycle_state<async_call, Ret>);
+    call->del = &d;
+    call->args.emplace(std::move(args)...);
+    // capturing a single pointer keeps the task inside the delegate's
+    // storage, i.e. submitting does not allocate.
+    executor.submit(delegate<void()>([call] { call->run(); }));
+    return future<Ret>(call);
+  }
+
+  template <typename Ret, typename... Args>
+  void impl::async_call<Ret, Args...>::run() {
+#ifdef PC_DELEGATE_NO_EXCEPTIONS
+    invoke();
+#else
+    try {
+      invoke();
+    } catch (...) {
+      this->exception = std::current_exception();
+    }
+#endif
+    args.reset();
+    // release the state even if a continuation set by then() throws.
+    state_release_guard<Ret> guard{this};
+    this->set_ready();
+  }
+
+  template <typename Ret, typename... Args>
+  void impl::async_call<Ret, Args...>::invoke() {
+    if constexpr (std::is_same_v<Ret, void>)
+      std::apply(*del, *args);
+    else
+      this->value.emplace(std::apply(*del, *args));
+  }
+
+  template <typename Ret>
+  impl::when_all_state<Ret>* impl::when_all_state<Ret>::make() {
+    auto* state = object_pool<when_all_state>::acquire();
+    state->reset(&recycle_state<when_all_state, when_all_t<Ret>>);
+    state->inputs.clear();
+    return state;
+  }
+
+  template <typename Ret>
+  future<impl::when_all_t<Ret>> impl::when_all_state<Ret>::arm() {
+    future<when_all_t<Ret>> result(this);
+    // one extra count, so that inputs which are ready already cannot
+    // complete the state before all continuations are set.
+    remaining.store(inputs.size() + 1, std::memory_order_relaxed);
+    for (auto& input : inputs) {
+      input.state->set_continuation(
+          delegate<void()>([this] { input_ready(); }));
+    }
+    input_ready();
+    return result;
+  }
+
+  template <typename Ret>
+  void impl::when_all_state<Ret>::input_ready() {
+    if (remaining.fetch_sub(1, std::memory_order_acq_rel) != 1)
+      return;
+#ifndef PC_DELEGATE_NO_EXCEPTIONS
+    // the first exception of the inputs becomes the exception of the result.
+    for (auto& input : inputs) {
+      if (input.state->exception) {
+        this->exception = input.state->exception;
+        break;
+      }
+    }
+#endif
+    if constexpr (!std::is_same_v<Ret, void>) {
+#ifndef PC_DELEGATE_NO_EXCEPTIONS
+      if (!this->exception)
+#endif
+      {
+        std::vector<ret_val_t<Ret>> values;
+        values.reserve(inputs.size());
+        for (auto& input : inputs)
+          values.push_back(input.get());
+        this->value.emplace(std::move(values));
+      }
+    }
+    // keeps the capacity of inputs for the next use of this state.
+    inputs.clear();
+    state_release_guard<when_all_t<Ret>> guard{this};
+    this->set_ready();
+  }
+
+  template <typename Ret, typename... Args>
+  template <typename Executor>
+  future<Ret> delegate<Ret(Args...)>::invoke_async(Executor& executor,
+                                                  Args... args) {
+    return impl::async_call<Ret, Args...>::start(executor, *this,
+                                                 std::move(args)...);
+  }
+
+  template <typename Ret, typename... Args>
+  template <typename Executor>
+  future<impl::when_all_t<Ret>>
+  multicast_delegate<Ret(Args...)>::invoke_async(Executor& executor,
+                                                 Args... args) {
+    // fills the pooled state's input vector directly, which keeps its
+    // capacity between calls, instead of going through when_all().
+    auto* state = impl::when_all_state<Ret>::make();
+    state->inputs.reserve(delegates.size());
+    for (auto& del : delegates)
+      state->inputs.push_back(del.invoke_async(executor, args...));
+    return state->arm();
+  }
+} // namespace pc
+
+#endif
@@ -0,0 +1,302 @@
+/**
+ * \file memoized_delegate.hpp
+ * \author Pele Constam (pelectron1602\gmail.com)
+ * \brief This file defines the \ref pc::memoized_delegate<Ret(Args...)>
+ * class, a delegate which caches the results of a pure callable.
+ * \version 0.1
+ * \date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef PC_MEMOIZED_DELEGATE_HPP
+#define PC_MEMOIZED_DELEGATE_HPP
+#include "delegate.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace pc {
+#ifndef GENERATING_DOCUMENTATION
+  /// forward declaration, intentionally left unimplemented.
+  template <typename>
+  class memoized_delegate;
+#endif
+
+  /**
+   * \brief \anchor memoized-delegate-brief a delegate which remembers the
+   * results of its callable for the most recently used arguments.
+   *
+   * Invoking it hashes the arguments and looks them up in a bounded cache.
+   * On a hit, the cached result is returned without invoking the callable.
+   * On a miss, the callable is invoked and its result is cached, evicting an
+   * older entry once the cache is full. The bound callable must therefore be
+   * pure, i.e. its result must only depend on its arguments.
+   *
+   * The cache consists of a vector of at most capacity() entries and an open
+   * addressed index with linear probing, which has at least twice as many
+   * slots as there are entries. Entries are evicted with the CLOCK algorithm:
+   * a hit marks an entry as referenced, and the clock hand evicts the first
+   * entry which is not referenced, clearing the marks it passes. Both vectors
+   * are allocated by the constructor, so after warm-up the cache only
+   * allocates if copying an argument or a result does.
+   *
+   * bind() and reset() clear the cache. The cache is not synchronized.
+   *
+   * A memoized_delegate is copyable, including its cache, and can therefore
+   * be bound to a multicast_delegate like any function object. To share one
+   * cache, bind std::ref() of it instead.
+   *
+   * \tparam Ret return type of the delegate. Must not be void or a reference.
+   * \tparam Args argument types of the delegate. std::hash and operator==
+   * must be defined for their decayed types. Must not be rvalue references.
+   */
+  template <typename Ret, typename... Args>
+  class memoized_delegate<Ret(Args...)> {
+    static_assert(!std::is_void_v<Ret> && !std::is_reference_v<Ret>,
+                  "only values can be memoized");
+    static_assert((!std::is_rvalue_reference_v<Args> && ...),
+                  "arguments which are moved from cannot be memoized");
+
+  public:
+    /// delegate type holding the callable.
+    using delegate_t = ::pc::delegate<Ret(Args...)>;
+    /// type the arguments are stored as.
+    using key_type = std::tuple<std::decay_t<Args>...>;
+    /// type the results are stored as.
+    using value_type = std::remove_cv_t<Ret>;
+
+    /// capacity of a default constructed memoized_delegate.
+    static constexpr size_t default_capacity = 256;
+
+    /**
+     * \brief construct with no callable bound.
+     * \param capacity maximum number of cached results. At least 1.
+     */
+    explicit memoized_delegate(size_t capacity = default_capacity);
+
+    /**
+     * \brief construct and bind a callable.
+     * \tparam BindArgs argument types, see the delegate_t constructors.
+     * \param capacity maximum number of cached results. At least 1.
+     * \param bind_args arguments to construct the delegate from.
+     */
+    template <typename... BindArgs>
+    explicit memoized_delegate(size_t capacity, BindArgs&&... bind_args);
+
+    /**
+     * \brief get the cached result for args, or invoke the callable and cache
+     * its result.
+     * \param args arguments
+     * \return Ret the result
+     */
+    Ret operator()(impl::param_t<Args>... args);
+
+    /**
+     * \brief bind a new callable and clear the cache.
+     * \tparam BindArgs argument types, see the delegate_t constructors.
+     * \param bind_args arguments to construct the delegate from, i.e. a free
+     * function, an object and member function, a function object or a
+     * delegate.
+     */
+    template <typename... BindArgs>
+    void bind(BindArgs&&... bind_args);
+
+    /// unbind the callable and clear the cache.
+    void reset();
+
+    /// query if a callable is bound.
+    bool is_valid() const { return del.is_valid(); }
+
+    /// remove all cached results. Keeps the statistics.
+    void clear();
+
+    /// get the number of cached results.
+    size_t size() const { return entries.size(); }
+
+    /// get the maximum number of cached results.
+    size_t capacity() const { return max_entries; }
+
+    /// get the hits and misses since construction or clear_stats().
+    const inline_cache_stats& stats() const { return cache_stats; }
+
+    /// get the number of evicted results since construction or clear_stats().
+    size_t evictions() const { return num_evictions; }
+
+    /// reset the statistics.
+    void clear_stats() {
+      cache_stats = {};
+      num_evictions = 0;
+    }
+
+  private:
+    /// a cached result.
+    struct entry {
+      size_t     hash;
+      key_type   key;
+      value_type value;
+      bool       referenced; //< hit since the clock hand last passed
+    };
+
+    /// marks an empty slot of the index.
+    static constexpr size_t empty_slot = static_cast<size_t>(-1);
+
+    /// hash the arguments.
+    static size_t hash_args(impl::param_t<Args>... args);
+
+    /// get the slot of the index a hash is probed from.
+    size_t home_slot(size_t hash) const { return hash & (index.size() - 1); }
+
+    /// find the slot of the index referring to the entry with number i.
+    size_t find_slot(size_t i) const;
+
+    /// remove slot from the index, shifting back the following slots of its
+    /// probe sequence.
+    void erase_slot(size_t slot);
+
+    /// get the number of an entry to reuse, evicting its result.
+    size_t evict();
+
+    delegate_t          del;
+    size_t              max_entries;
+    std::vector<entry>  entries; //< the cached results, in insertion order
+    std::vector<size_t> index;   //< entry numbers, or empty_slot
+    size_t              hand{0}; //< the CLOCK hand, an entry number
+    inline_cache_stats  cache_stats;
+    size_t              num_evictions{0};
+  };
+
+  template <typename Ret, typename... Args>
+  memoized_delegate<Ret(Args...)>::memoized_delegate(size_t capacity)
+      : max_entries(capacity == 0 ? 1 : capacity) {
+    size_t slots = 1;
+    while (slots < 2 * max_entries)
+      slots *= 2;
+    index.assign(slots, empty_slot);
+    entries.reserve(max_entries);
+  }
+
+  template <typename Ret, typename... Args>
+  template <typename... BindArgs>
+  memoized_delegate<Ret(Args...)>::memoized_delegate(size_t capacity,
+                                                     BindArgs&&... bind_args)
+      : memoized_delegate(capacity) {
+    del = delegate_t(std::forward<BindArgs>(bind_args)...);
+  }
+
+  template <typename Ret, typename... Args>
+  Ret memoized_delegate<Ret(Args...)>::operator()(
+      impl::param_t<Args>... args) {
+    const size_t hash = hash_args(args...);
+    size_t       slot = home_slot(hash);
+    for (; index[slot] != empty_slot; slot = (slot + 1) & (index.size() - 1)) {
+      entry& e = entries[index[slot]];
+      if (e.hash == hash && e.key == std::forward_as_tuple(args...)) {
+        ++cache_stats.hits;
+        e.referenced = true;
+        return e.value;
+      }
+    }
+    ++cache_stats.misses;
+    // invoke before touching the cache, so that a throwing or reentrant
+    // callable leaves it consistent.
+    value_type value = del(args...);
+    size_t     i;
+    if (entries.size() < max_entries) {
+      i = entries.size();
+      entries.push_back(entry{hash, key_type(args...), std::move(value),
+                              false});
+    } else {
+      i = evict();
+      entries[i].hash = hash;
+      entries[i].key = key_type(args...);
+      entries[i].value = std::move(value);
+      entries[i].referenced = false;
+    }
+    // the eviction may have shifted slots, so probe again.
+    slot = home_slot(hash);
+    while (index[slot] != empty_slot)
+      slot = (slot + 1) & (index.size() - 1);
+    index[slot] = i;
+    return entries[i].value;
+  }
+
+  template <typename Ret, typename... Args>
+  template <typename... BindArgs>
+  void memoized_delegate<Ret(Args...)>::bind(BindArgs&&... bind_args) {
+    del = delegate_t(std::forward<BindArgs>(bind_args)...);
+    clear();
+  }
+
+  template <typename Ret, typename... Args>
+  void memoized_delegate<Ret(Args...)>::reset() {
+    del.reset();
+    clear();
+  }
+
+  template <typename Ret, typename... Args>
+  void memoized_delegate<Ret(Args...)>::clear() {
+    entries.clear();
+    std::fill(index.begin(), index.end(), empty_slot);
+    hand = 0;
+  }
+
+  template <typename Ret, typename... Args>
+  size_t
+      memoized_delegate<Ret(Args...)>::hash_args(impl::param_t<Args>... args) {
+    size_t hash = 0;
+    ((hash ^= std::hash<std::decay_t<Args>>{}(args) + 0x9e3779b9u +
+              (hash << 6) + (hash >> 2)),
+     ...);
+    // std::hash of integers is usually the identity. Mix the bits, so that
+    // consecutive keys do not form long probe sequences.
+    const uint64_t mixed = static_cast<uint64_t>(hash) * 0x9e3779b97f4a7c15u;
+    return static_cast<size_t>(mixed ^ (mixed >> 32));
+  }
+
+  template <typename Ret, typename... Args>
+  size_t memoized_delegate<Ret(Args...)>::find_slot(size_t i) const {
+    size_t slot = home_slot(entries[i].hash);
+    while (index[slot] != i)
+      slot = (slot + 1) & (index.size() - 1);
+    return slot;
+  }
+
+  template <typename Ret, typename... Args>
+  void memoized_delegate<Ret(Args...)>::erase_slot(size_t slot) {
+    const size_t mask = index.size() - 1;
+    for (size_t next = (slot + 1) & mask; index[next] != empty_slot;
+         next = (next + 1) & mask) {
+      // move the entry at next into the hole, unless its home slot lies
+      // cyclically in (slot, next], i.e. it would become unreachable.
+      const size_t home = home_slot(entries[index[next]].hash);
+      if (((next - home) & mask) >= ((next - slot) & mask)) {
+        index[slot] = index[next];
+        slot = next;
+      }
+    }
+    index[slot] = empty_slot;
+  }
+
+  template <typename Ret, typename... Args>
+  size_t memoized_delegate<Ret(Args...)>::evict() {
+    while (entries[hand].referenced) {
+      entries[hand].referenced = false;
+      hand = (hand + 1) % entries.size();
+    }
+    const size_t victim = hand;
+    hand = (hand + 1) % entries.size();
+    erase_slot(find_slot(victim));
+    ++num_evictions;
+    return victim;
+  }
+} // namespace pc
+
+#endif
@@ -15,6 +15,17 @@
 #define PC_MULTICAST_DELEGATE_HPP
 #include "delegate.hpp"
 
+#include <algorithm>
+#include <atomic>
+#ifndef PC_DELEGATE_NO_EXCEPTIONS
+#include <exception>
+#endif
+#include <functional>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
 #include <vector>
 
 namespace pc {
@@ -26,8 +37,9 @@ namespace pc {
 
   namespace impl {
 
-    /// meta function for the results vector's value_type.
-    /// \tparam Ret multicast_delegate return type.
+    /// meta function for the value type of futures and multicast_delegate
+    /// results.
+    /// \tparam Ret return type.
     template <typename Ret>
     struct ret_val {
       /// result of meta function
@@ -36,7 +48,7 @@ namespace pc {
 
     /// specialization for (possibly const) case where Ret is a reference
     /// type.
-    /// \tparam Ret multicast_delegate return type.
+    /// \tparam Ret return type.
     template <typename Ret>
     struct ret_val<Ret &> {
       /// result of meta function
@@ -44,17 +56,24 @@ namespace pc {
     };
 
     /// specialization for r value reference return type.
-    /// \tparam Ret multicast_delegate return type.
+    /// \tparam Ret return type.
     template <typename Ret>
     struct ret_val<Ret &&> {
       /// result of meta function
       using type = Ret;
     };
 
-    // get the result vector's value_type.
+    // get the value type.
     template <typename Ret>
     using ret_val_t = typename ret_val<Ret>::type;
 
+    /// value type of when_all() for futures of type Ret, and of the future
+    /// returned by multicast_delegate::invoke_async().
+    template <typename Ret>
+    using when_all_t =
+        std::conditional_t<std::is_same_v<Ret, void>, void,
+                           std::vector<ret_val_t<Ret>>>;
+
     /**
      * This class stores the values returned by the delegates
      *
@@ -84,6 +103,34 @@ namespace pc {
       /// no storage for values
     };
 
+    /// group index of callables which are not part of any group.
+    static constexpr size_t no_group = static_cast<size_t>(-1);
+
+    /**
+     * \brief bookkeeping for a single bound callable. A multicast_delegate
+     * keeps one of these in parallel to each entry of its delegate vector.
+     */
+    struct subscriber_info {
+      int    priority; //< callables with higher priority are invoked first
+      size_t group;    //< index into the group table or no_group
+      size_t sequence; //< bind order, keeps equal priorities in bind order
+    };
+
+    /// \brief a named group of callables which can be enabled and disabled in
+    /// bulk.
+    struct group_info {
+      std::string name;    //< name of the group
+      bool        enabled; //< true if the group's callables are invoked
+    };
+
+    /// ordering of the delegate vector. Returns true if a must be invoked
+    /// before b.
+    inline bool invoked_before(const subscriber_info &a,
+                               const subscriber_info &b) {
+      return a.priority > b.priority ||
+             (a.priority == b.priority && a.sequence < b.sequence);
+    }
+
   } // namespace impl
 
   /**
@@ -106,6 +153,37 @@ namespace pc {
    *
    * To clear both vectors at once, use the total_reset() member function.
    *
+   * \section multicast-delegate-priorities Priorities and groups
+   * Every callable is bound with a priority. Callables with a higher priority
+   * are invoked before callables with a lower one, callables with equal
+   * priority are invoked in the order they were bound. The plain bind()
+   * overloads use #default_priority. The delegate vector is kept sorted when
+   * binding, so invoking the multicast_delegate is still a single linear scan
+   * over the delegate vector.
+   *
+   * Callables can also be bound into a named group with bind_to_group().
+   * Disabling a group moves its callables out of the delegate vector into a
+   * separate list of parked callables, enabling it merges them back in at
+   * their original position. Disabled callables therefore cost nothing when
+   * invoking the multicast_delegate.
+   *
+   * \section multicast-delegate-arguments Arguments
+   * The arguments are materialized once, as the parameters of operator(), and
+   * passed on to every callable as [param_t](#param_t)<Args>, i.e. by const
+   * reference unless they are references or small and trivially copyable.
+   * An argument is therefore only copied for callables which take it by
+   * value.
+   *
+   * \section multicast-delegate-reentrancy Re-entrancy
+   * The bound callables may bind, unbind, reset, enable or disable groups of
+   * and invoke the multicast_delegate they are called from. While the
+   * multicast_delegate is being invoked, modifications of the delegate vector
+   * are queued and applied in order when the outermost invocation returns.
+   * Invocations therefore always see the callables bound when the outermost
+   * invocation started. If a callable throws, the changes stay queued and
+   * are applied before the next invocation or modification. Invoking a multicast_delegate which is not modified
+   * during the invocation does not copy anything.
+   *
    * \note Depending on the return type of the delegate, the underlying way of
    * storing the returned values can change quite a bit. Suppose T is the type
    * one gets when removing all reference qualifiers from the return
@@ -140,18 +218,109 @@ namespace pc {
     using const_delegate_iterator = typename delegate_vector_t::const_iterator;
     /// value_type of the results vector.
     using value_type = impl::ret_val_t<Ret>;
+    /// priority type. Higher priorities are invoked first.
+    using priority_t = int;
+    /// identifies a bound callable. Returned by the bind() overloads.
+    using subscription_id = size_t;
+
+    /// priority used by the bind() overloads without a priority parameter.
+    static constexpr priority_t default_priority = 0;
 
     /// default constructor
     multicast_delegate() = default;
-    /// default copy constructor
-    multicast_delegate(const multicast_delegate &) = default;
-    /// default move constructor
-    multicast_delegate(multicast_delegate &&) = default;
+    /// copy constructor. Copies the callables, groups and results. The copy
+    /// is not being invoked, even if other is, i.e. changes queued in other
+    /// are not copied.
+    multicast_delegate(const multicast_delegate &other);
+    /// move constructor. Like the copy constructor, the new
+    /// multicast_delegate is not being invoked.
+    multicast_delegate(multicast_delegate &&other);
 
     /// invoke the multicast_delegate
     void operator()(Args... args);
 
-    /// get the number of callables bound to the multicast_delegate
+    /**
+     * invoke the multicast_delegate in parallel. The delegate vector is split
+     * into contiguous chunks, which are invoked on the executor's threads and
+     * on the calling thread. Each chunk collects its returned values on its
+     * own; they are appended to the results vector in the order of the
+     * delegate vector once all chunks are done, i.e. the results are the same
+     * as those of operator().
+     * \note The bound callables are invoked concurrently and must not modify
+     * this multicast_delegate.
+     * \note If a callable throws, the other chunks still run to completion,
+     * no results are appended and the first exception in the order of the
+     * delegate vector is rethrown once all chunks are done.
+     * \tparam Executor executor type, e.g. \ref pc::thread_pool. Must provide
+     * submit(delegate<void()>), try_run_one() and num_workers().
+     * \param executor executor to run the chunks on
+     * \param args arguments
+     */
+    template <typename Executor>
+    void parallel_invoke(Executor &executor, Args... args);
+
+    /**
+     * invoke every bound callable on the executor. Unlike parallel_invoke(),
+     * this returns right away; the returned values are not appended to the
+     * results vector but passed to the returned future, in the order of the
+     * delegate vector.
+     * \note Defined in future.hpp, which must be included to use this
+     * function. The multicast_delegate must not be modified or destroyed
+     * until the returned future is ready.
+     * \tparam Executor executor type, e.g. \ref pc::thread_pool. Must provide
+     * submit(delegate<void()>).
+     * \param executor executor to invoke the callables on
+     * \param args arguments, copied once per callable
+     * \return future<std::vector<value_type>> the returned values, or
+     * future<void> for Ret = void. Ready once all callables have returned.
+     */
+    template <typename Executor>
+    future<impl::when_all_t<Ret>> invoke_async(Executor &executor,
+                                               Args... args);
+
+    /// awaitable returned by emit_async(), defined in coroutine.hpp.
+    class emit_awaiter;
+
+    /**
+     * emit to coroutines. Ret must be a \ref pc::task<T>. Awaiting the
+     * returned object invokes every bound callable and starts the returned
+     * tasks one after the other on the awaiting thread, each running until its
+     * first suspension. The awaiting coroutine is resumed once all tasks are
+     * done, on the thread which finishes the last one:
+     *
+     *     std::vector<T> values = co_await md.emit_async(args...);
+     *
+     * The arguments are stored in the awaitable, i.e. callables taking
+     * references may use them until their task is done.
+     * \note Defined in coroutine.hpp, which must be included to use this
+     * function, and only if PC_HAS_COROUTINES is defined. The
+     * multicast_delegate must not be modified or destroyed until the await
+     * is complete, except by the callables before their first suspension.
+     * \param args arguments
+     * \return emit_awaiter awaitable resulting in a std::vector<T> of the
+     * values, in the order of the delegate vector, or void for T = void.
+     */
+    emit_awaiter emit_async(Args... args);
+
+    /**
+     * invoke the multicast_delegate once for every event of a batch. The
+     * loops are interchanged compared to calling operator() once per event:
+     * each callable is invoked for all events before the next callable is
+     * invoked, which keeps the callable's code and data hot.
+     *
+     * The returned values are appended callable-major, i.e. the value returned
+     * by the s-th callable for the e-th event is at index
+     * `num_results() + s * size(events) + e`, where num_results() is taken
+     * before the call.
+     * \tparam Range contiguous range of std::tuple<Args...>, e.g. a
+     * std::vector, std::array or (C++20) std::span.
+     * \param events the arguments of each invocation
+     */
+    template <typename Range>
+    void invoke_batch(const Range &events);
+
+    /// get the number of callables bound to the multicast_delegate. Callables
+    /// in disabled groups are not counted.
     size_t num_callables() const;
 
     /**
@@ -163,8 +332,8 @@ namespace pc {
     /// clear the results vector. The delegate vector will be unchanged.
     void clear_results();
 
-    /// reset the multicast_delegate, i.e. clear the delegate vector. The
-    /// results vector will be unchanged.
+    /// reset the multicast_delegate, i.e. clear the delegate vector and unbind
+    /// the callables of disabled groups. The results vector will be unchanged.
     void reset();
 
     /// equivalent to calling clear_results() and reset().
@@ -174,8 +343,9 @@ namespace pc {
      * bind a free function. This appends a new delegate to the delegate
      * vector.
      * \param free_function pointer to free function
+     * \return subscription_id id to pass to unbind()
      */
-    void bind(Ret (*free_function)(Args...));
+    subscription_id bind(Ret (*free_function)(Args...));
 
     /**
      * bind an object and member function. This appends a new delegate to
@@ -183,9 +353,10 @@ namespace pc {
      * \tparam T object type
      * \param object object instance
      * \param member_func pointer to member function to bind
+     * \return subscription_id id to pass to unbind()
      */
     template <typename T>
-    void bind(T &object, Ret (T::*member_func)(Args...));
+    subscription_id bind(T &object, Ret (T::*member_func)(Args...));
 
     /**
      * bind an object and const member function. This appends a new
@@ -193,32 +364,96 @@ namespace pc {
      * \tparam T object type
      * \param object object instance
      * \param member_func pointer to const member function.
+     * \return subscription_id id to pass to unbind()
      */
     template <typename T>
-    void bind(T &object, Ret (T::*member_func)(Args...) const);
+    subscription_id bind(T &object, Ret (T::*member_func)(Args...) const);
 
     /**
      * bind a function object. This appends a new delegate to the
      * delegate vector.
      * \tparam F function object type
      * \param f function object instance
+     * \return subscription_id id to pass to unbind()
      */
     template <typename F,
               std::enable_if_t<!std::is_same_v<std::decay_t<F>, delegate_t>> * =
                   nullptr>
-    void bind(F &&f);
+    subscription_id bind(F &&f);
 
     /**
      * bind a delegate. This appends d to the delegate vector.
      * \param d delegate
+     * \return subscription_id id to pass to unbind()
      */
-    void bind(delegate_t &&d);
+    subscription_id bind(delegate_t &&d);
 
     /**
      * bind a delegate. This appends d to the delegate vector.
      * \param d delegate
+     * \return subscription_id id to pass to unbind()
+     */
+    subscription_id bind(const delegate_t &d);
+
+    /**
+     * bind a callable with a priority. The callable is inserted into the
+     * delegate vector after all callables with a priority greater than or
+     * equal to priority.
+     * \tparam BindArgs argument types, see the delegate_t constructors.
+     * \param priority priority of the callable
+     * \param bind_args arguments to construct the delegate from, i.e. a free
+     * function, an object and member function, a function object or a
+     * delegate.
+     * \return subscription_id id to pass to unbind()
      */
-    void bind(const delegate_t &d);
+    template <typename... BindArgs>
+    subscription_id bind(priority_t priority, BindArgs &&...bind_args);
+
+    /**
+     * bind a callable with a priority into a named group. The group is
+     * created if it does not exist yet. If the group is disabled, the
+     * callable will not be invoked until the group is enabled.
+     * \tparam BindArgs argument types, see the delegate_t constructors.
+     * \param group name of the group
+     * \param priority priority of the callable
+     * \param bind_args arguments to construct the delegate from.
+     * \return subscription_id id to pass to unbind()
+     */
+    template <typename... BindArgs>
+    subscription_id bind_to_group(std::string_view group, priority_t priority,
+                                  BindArgs &&...bind_args);
+
+    /**
+     * unbind a single callable.
+     * \param id id returned when binding the callable
+     * \return true the callable was bound and is unbound now
+     * \return false no callable with this id is bound
+     */
+    bool unbind(subscription_id id);
+
+    /**
+     * enable a group. Its callables are merged back into the delegate vector.
+     * Does nothing if the group does not exist or is already enabled.
+     * \param group name of the group
+     */
+    void enable_group(std::string_view group);
+
+    /**
+     * disable a group. Its callables are moved out of the delegate vector and
+     * will not be invoked until the group is enabled again. Disabling a group
+     * which does not exist yet creates it, so that callables bound to it later
+     * start out disabled.
+     * \param group name of the group
+     */
+    void disable_group(std::string_view group);
+
+    /**
+     * query if a group is enabled.
+     * \param group name of the group
+     * \return true the group is enabled or does not exist
+     * \return false the group is disabled
+     */
+    bool is_group_enabled(std::string_view group) const;
 
     /// get iterator to the beginning of the delegate array.
     delegate_iterator delegate_begin();
@@ -272,12 +507,115 @@ namespace pc {
     const_result_iterator cend() const;
 
   private:
-    delegate_vector_t                 delegates;
-    [[maybe_unused]] result_storage_t collector;
+    /// a callable of a disabled group.
+    struct parked_subscriber {
+      impl::subscriber_info info;
+      delegate_t            del;
+    };
+
+    /// a modification queued during an invocation.
+    struct pending_change {
+      enum class kind { bind, unbind, reset, enable_group, disable_group };
+      kind                  what;
+      impl::subscriber_info info; //< unbind uses info.sequence, groups use
+                                  //< info.group
+      delegate_t            del;  //< the callable to bind
+    };
+
+    /// references to the arguments of parallel_invoke().
+    using arg_refs_t = std::tuple<Args &...>;
+
+    /// a contiguous part of the delegate vector invoked by parallel_invoke().
+    struct invoke_chunk {
+      multicast_delegate  *self;
+      arg_refs_t          *args;
+      size_t               first;
+      size_t               last;
+      std::atomic<size_t> *remaining; //< chunks not finished yet
+      result_storage_t     results;
+#ifndef PC_DELEGATE_NO_EXCEPTIONS
+      std::exception_ptr error; //< thrown by one of the delegates
+#endif
+
+      /// invoke the delegates and count the chunk as finished, even if one
+      /// of them throws. The exception is kept in error.
+      void run();
+
+      /// invoke the delegates [first, last).
+      void invoke();
+    };
+
+    /// marks the multicast_delegate as being invoked for its lifetime. The
+    /// outermost guard applies the queued changes in finish(), i.e. only if
+    /// the invocation returns normally, as applying them may allocate.
+    struct emit_guard {
+      explicit emit_guard(multicast_delegate &m) : self(m) {
+        self.flush_pending();
+        ++self.emit_depth;
+      }
+      ~emit_guard() {
+        if (!finished)
+          --self.emit_depth;
+      }
+      /// end the invocation. The outermost one applies the queued changes.
+      void finish() {
+        finished = true;
+        --self.emit_depth;
+        self.flush_pending();
+      }
+      multicast_delegate &self;
+      bool                finished{false};
+    };
+
+    /// insert d into the delegate vector according to info, or park it if its
+    /// group is disabled. Queues the insertion while invoking.
+    subscription_id insert(impl::subscriber_info info, delegate_t &&d);
+    /// remove the callable with sequence id from the delegate vector or the
+    /// parked list.
+    bool remove(subscription_id id);
+    /// enable or disable the group with the given index.
+    void set_group_enabled(size_t index, bool enabled);
+    /// apply the changes queued while invoking.
+    void apply_pending();
+    /// apply changes left queued by a callable which threw, unless invoking.
+    void flush_pending();
+    /// clear the delegate vector and the parked list.
+    void clear_callables();
+    /// get the index of a group, or impl::no_group if it does not exist.
+    size_t find_group(std::string_view group) const;
+    /// get the index of a group. Creates the group if it does not exist.
+    size_t make_group(std::string_view group);
+
+    delegate_vector_t                  delegates;
+    std::vector<impl::subscriber_info> infos; //< parallel to delegates
+    std::vector<parked_subscriber>     parked;
+    std::vector<impl::group_info>      groups;
+    std::vector<pending_change>        pending; //< changes made while invoking
+    size_t                             emit_depth{0};
+    size_t                             next_sequence{0};
+    [[maybe_unused]] result_storage_t  collector;
   };
 
+  template <typename Ret, typename... Args>
+  multicast_delegate<Ret(Args...)>::multicast_delegate(
+      const multicast_delegate &other)
+      : delegates(other.delegates), infos(other.infos), parked(other.parked),
+        groups(other.groups), next_sequence(other.next_sequence),
+        collector(other.collector) {}
+
+  template <typename Ret, typename... Args>
+  multicast_delegate<Ret(Args...)>::multicast_delegate(
+      multicast_delegate &&other)
+      : delegates(std::move(other.delegates)), infos(std::move(other.infos)),
+        parked(std::move(other.parked)), groups(std::move(other.groups)),
+        next_sequence(other.next_sequence),
+        collector(std::move(other.collector)) {}
+
   template <typename Ret, typename... Args>
   void multicast_delegate<Ret(Args...)>::operator()(Args... args) {
+    // changes to the delegate vector made by the callables are queued until
+    // the outermost invocation returns, so iterating directly is safe.
+    emit_guard guard(*this);
     if constexpr (std::is_same_v<Ret, void>) {
       for (auto &del : delegates) {
         del(args...);
@@ -293,6 +631,132 @@ namespace pc {
         collector.values.push_back(del(args...));
       }
     }
+    guard.finish();
+  }
+
+  template <typename Ret, typename... Args>
+  template <typename Executor>
+  void multicast_delegate<Ret(Args...)>::parallel_invoke(Executor &executor,
+                                                         Args... args) {
+    emit_guard   guard(*this);
+    const size_t n = delegates.size();
+    if (n == 0)
+      return;
+    // a few chunks per thread, so that threads which finish early can steal.
+    const size_t num_chunks = std::min(n, 4 * (executor.num_workers() + 1));
+    arg_refs_t                arg_refs(args...);
+    std::atomic<size_t>       remaining{num_chunks};
+    std::vector<invoke_chunk> chunks(num_chunks);
+    for (size_t c = 0; c < num_chunks; ++c) {
+      chunks[c].self = this;
+      chunks[c].args = &arg_refs;
+      chunks[c].first = n * c / num_chunks;
+      chunks[c].last = n * (c + 1) / num_chunks;
+      chunks[c].remaining = &remaining;
+    }
+    for (size_t c = 1; c < num_chunks; ++c) {
+      // capturing a single pointer keeps the task inside the delegate's
+      // storage, i.e. submitting does not allocate.
+      executor.submit(
+          ::pc::delegate<void()>([chunk = &chunks[c]] { chunk->run(); }));
+    }
+    chunks[0].run();
+    // the chunks refer to this stack frame, i.e. wait for all of them even if
+    // a task run here throws.
+#ifdef PC_DELEGATE_NO_EXCEPTIONS
+    while (remaining.load(std::memory_order_acquire) != 0) {
+      if (!executor.try_run_one())
+        std::this_thread::yield();
+    }
+#else
+    std::exception_ptr task_error;
+    while (remaining.load(std::memory_order_acquire) != 0) {
+      try {
+        if (!executor.try_run_one())
+          std::this_thread::yield();
+      } catch (...) {
+        if (!task_error)
+          task_error = std::current_exception();
+      }
+    }
+    for (auto &chunk : chunks) {
+      if (chunk.error)
+        std::rethrow_exception(chunk.error);
+    }
+    if (task_error)
+      std::rethrow_exception(task_error);
+#endif
+    if constexpr (!std::is_same_v<Ret, void>) {
+      collector.values.reserve(collector.values.size() + n);
+      for (auto &chunk : chunks) {
+        std::move(chunk.results.values.begin(), chunk.results.values.end(),
+                  std::back_inserter(collector.values));
+      }
+    }
+    guard.finish();
+  }
+
+  template <typename Ret, typename... Args>
+  template <typename Range>
+  void multicast_delegate<Ret(Args...)>::invoke_batch(const Range &events) {
+    const auto *first = std::data(events);
+    const size_t count = std::size(events);
+    static_assert(
+        std::is_same_v<std::remove_cv_t<std::remove_pointer_t<decltype(first)>>,
+                       std::tuple<Args...>>,
+        "events must be a contiguous range of std::tuple<Args...>");
+    emit_guard guard(*this);
+    if constexpr (!std::is_same_v<Ret, void>) {
+      collector.values.reserve(collector.values.size() +
+                               count * delegates.size());
+    }
+    for (auto &del : delegates) {
+      auto call = [&del](auto &&...a) -> Ret {
+        return del(std::forward<decltype(a)>(a)...);
+      };
+      for (size_t e = 0; e < count; ++e) {
+        if constexpr (std::is_same_v<Ret, void>) {
+          std::apply(call, first[e]);
+        } else if constexpr (std::is_rvalue_reference_v<Ret>) {
+          collector.values.push_back(std::move(std::apply(call, first[e])));
+        } else {
+          collector.values.push_back(std::apply(call, first[e]));
+        }
+      }
+    }
+    guard.finish();
+  }
+
+  template <typename Ret, typename... Args>
+  void multicast_delegate<Ret(Args...)>::invoke_chunk::run() {
+    struct finish_guard {
+      std::atomic<size_t> *remaining;
+      ~finish_guard() { remaining->fetch_sub(1, std::memory_order_release); }
+    } guard{remaining};
+#ifdef PC_DELEGATE_NO_EXCEPTIONS
+    invoke();
+#else
+    try {
+      invoke();
+    } catch (...) {
+      error = std::current_exception();
+    }
+#endif
+  }
+
+  template <typename Ret, typename... Args>
+  void multicast_delegate<Ret(Args...)>::invoke_chunk::invoke() {
+    for (size_t i = first; i < last; ++i) {
+      auto &del = self->delegates[i];
+      auto  call = [&del](Args &...a) -> Ret { return del(a...); };
+      if constexpr (std::is_same_v<Ret, void>) {
+        std::apply(call, *args);
+      } else if constexpr (std::is_rvalue_reference_v<Ret>) {
+        results.values.push_back(std::move(std::apply(call, *args)));
+      } else {
+        results.values.push_back(std::apply(call, *args));
+      }
+    }
   }
 
   template <typename Ret, typename... Args>
@@ -317,44 +781,288 @@ namespace pc {
 
   template <typename Ret, typename... Args>
   void multicast_delegate<Ret(Args...)>::reset() {
+    if (emit_depth != 0) {
+      pending.push_back(
+          pending_change{pending_change::kind::reset, {}, delegate_t{}});
+      return;
+    }
+    flush_pending();
+    clear_callables();
+  }
+
+  template <typename Ret, typename... Args>
+  void multicast_delegate<Ret(Args...)>::clear_callables() {
     delegates.clear();
+    infos.clear();
+    parked.clear();
   }
 
   template <typename Ret, typename... Args>
-  void multicast_delegate<Ret(Args...)>::bind(Ret (*free_function)(Args...)) {
-    delegates.push_back(delegate_t(free_function));
+  typename multicast_delegate<Ret(Args...)>::subscription_id
+      multicast_delegate<Ret(Args...)>::bind(Ret (*free_function)(Args...)) {
+    return bind(default_priority, free_function);
   }
 
   template <typename Ret, typename... Args>
   template <typename T>
-  void multicast_delegate<Ret(Args...)>::bind(T &object,
+  typename multicast_delegate<Ret(Args...)>::subscription_id
+      multicast_delegate<Ret(Args...)>::bind(T &object,
                                               Ret (T::*member_func)(Args...)) {
-    delegates.push_back(delegate_t(object, member_func));
+    return bind(default_priority, object, member_func);
   }
 
   template <typename Ret, typename... Args>
   template <typename T>
-  void multicast_delegate<Ret(Args...)>::bind(T &object,
+  typename multicast_delegate<Ret(Args...)>::subscription_id
+      multicast_delegate<Ret(Args...)>::bind(T &object,
                                               Ret (T::*member_func)(Args...)
                                                   const) {
-    delegates.push_back(delegate_t(object, member_func));
+    return bind(default_priority, object, member_func);
   }
 
   template <typename Ret, typename... Args>
   template <typename F, std::enable_if_t<!std::is_same_v<
                             std::decay_t<F>, delegate<Ret(Args...)>>> *>
-  void multicast_delegate<Ret(Args...)>::bind(F &&f) {
-    delegates.push_back(delegate_t(std::forward<F>(f)));
+  typename multicast_delegate<Ret(Args...)>::subscription_id
+      multicast_delegate<Ret(Args...)>::bind(F &&f) {
+    return bind(default_priority, std::forward<F>(f));
+  }
+
+  template <typename Ret, typename... Args>
+  typename multicast_delegate<Ret(Args...)>::subscription_id
+      multicast_delegate<Ret(Args...)>::bind(const delegate_t &d) {
+    return bind(default_priority, d);
+  }
+
+  template <typename Ret, typename... Args>
+  typename multicast_delegate<Ret(Args...)>::subscription_id
+      multicast_delegate<Ret(Args...)>::bind(delegate_t &&d) {
+    return bind(default_priority, std::move(d));
+  }
+
+  template <typename Ret, typename... Args>
+  template <typename... BindArgs>
+  typename multicast_delegate<Ret(Args...)>::subscription_id
+      multicast_delegate<Ret(Args...)>::bind(priority_t priority,
+                                              BindArgs &&...bind_args) {
+    flush_pending();
+    return insert(
+        impl::subscriber_info{priority, impl::no_group, next_sequence++},
+           delegate_t(std::forward<BindArgs>(bind_args)...));
+  }
+
+  template <typename Ret, typename... Args>
+  template <typename... BindArgs>
+  typename multicast_delegate<Ret(Args...)>::subscription_id
+      multicast_delegate<Ret(Args...)>::bind_to_group(
+      std::string_view group, priority_t priority, BindArgs &&...bind_args) {
+    flush_pending();
+    return insert(
+        impl::subscriber_info{priority, make_group(group), next_sequence++},
+           delegate_t(std::forward<BindArgs>(bind_args)...));
+  }
+
+  template <typename Ret, typename... Args>
+  bool multicast_delegate<Ret(Args...)>::unbind(subscription_id id) {
+    if (emit_depth == 0) {
+      flush_pending();
+      return remove(id);
+    }
+    // while invoking, the callable is bound once the queued changes are
+    // applied if it is bound now or queued to be bound, and neither a later
+    // unbind nor a reset is queued.
+    bool found = false;
+    for (const auto &info : infos)
+      found = found || info.sequence == id;
+    for (const auto &p : parked)
+      found = found || p.info.sequence == id;
+    for (const auto &change : pending) {
+      if (change.what == pending_change::kind::reset)
+        found = false;
+      else if (change.info.sequence == id &&
+               change.what == pending_change::kind::bind)
+        found = true;
+      else if (change.info.sequence == id &&
+               change.what == pending_change::kind::unbind)
+        found = false;
+    }
+    if (found) {
+      pending.push_back(pending_change{pending_change::kind::unbind,
+                                       impl::subscriber_info{0, 0, id},
+                                       delegate_t{}});
+    }
+    return found;
   }
 
   template <typename Ret, typename... Args>
-  void multicast_delegate<Ret(Args...)>::bind(const delegate_t &d) {
-    delegates.push_back(d);
+  void multicast_delegate<Ret(Args...)>::enable_group(std::string_view group) {
+    const size_t index = find_group(group);
+    if (index == impl::no_group)
+      return;
+    if (emit_depth != 0) {
+      pending.push_back(pending_change{pending_change::kind::enable_group,
+                                       impl::subscriber_info{0, index, 0},
+                                       delegate_t{}});
+      return;
+    }
+    flush_pending();
+    set_group_enabled(index, true);
+  }
+
+  template <typename Ret, typename... Args>
+  void multicast_delegate<Ret(Args...)>::disable_group(std::string_view group) {
+    const size_t index = make_group(group);
+    if (emit_depth != 0) {
+      pending.push_back(pending_change{pending_change::kind::disable_group,
+                                       impl::subscriber_info{0, index, 0},
+                                       delegate_t{}});
+      return;
+    }
+    flush_pending();
+    set_group_enabled(index, false);
   }
 
   template <typename Ret, typename... Args>
-  void multicast_delegate<Ret(Args...)>::bind(delegate_t &&d) {
-    delegates.push_back(std::move(d));
+  bool multicast_delegate<Ret(Args...)>::is_group_enabled(
+      std::string_view group) const {
+    const size_t index = find_group(group);
+    return index == impl::no_group || groups[index].enabled;
+  }
+
+  template <typename Ret, typename... Args>
+  typename multicast_delegate<Ret(Args...)>::subscription_id
+      multicast_delegate<Ret(Args...)>::insert(impl::subscriber_info info,
+                                               delegate_t          &&d) {
+    if (emit_depth != 0) {
+      pending.push_back(
+          pending_change{pending_change::kind::bind, info, std::move(d)});
+      return info.sequence;
+    }
+    if (info.group != impl::no_group && !groups[info.group].enabled) {
+      parked.push_back(parked_subscriber{info, std::move(d)});
+      return info.sequence;
+    }
+    const auto pos =
+        std::upper_bound(infos.begin(), infos.end(), info, impl::invoked_before);
+    const auto offset = pos - infos.begin();
+    infos.insert(pos, info);
+    delegates.insert(delegates.begin() + offset, std::move(d));
+    return info.sequence;
+  }
+
+  template <typename Ret, typename... Args>
+  bool multicast_delegate<Ret(Args...)>::remove(subscription_id id) {
+    for (size_t i = 0; i < infos.size(); ++i) {
+      if (infos[i].sequence == id) {
+        infos.erase(infos.begin() + i);
+        delegates.erase(delegates.begin() + i);
+        return true;
+      }
+    }
+    for (size_t i = 0; i < parked.size(); ++i) {
+      if (parked[i].info.sequence == id) {
+        parked.erase(parked.begin() + i);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  template <typename Ret, typename... Args>
+  void multicast_delegate<Ret(Args...)>::set_group_enabled(size_t index,
+                                                           bool   enabled) {
+    if (groups[index].enabled == enabled)
+      return;
+    groups[index].enabled = enabled;
+    if (enabled) {
+      // insert() keeps the delegate vector sorted, so the parked callables
+      // end up at the same position they had before the group was disabled.
+      std::vector<parked_subscriber> still_parked;
+      for (auto &p : parked) {
+        if (p.info.group == index)
+          insert(p.info, std::move(p.del));
+        else
+          still_parked.push_back(std::move(p));
+      }
+      parked = std::move(still_parked);
+      return;
+    }
+    // stable compaction of the delegate vector. Callables of the group are
+    // moved to the parked list, all others keep their relative order.
+    size_t out = 0;
+    for (size_t i = 0; i < delegates.size(); ++i) {
+      if (infos[i].group == index) {
+        parked.push_back(parked_subscriber{infos[i], std::move(delegates[i])});
+      } else {
+        if (out != i) {
+          delegates[out] = std::move(delegates[i]);
+          infos[out] = infos[i];
+        }
+        ++out;
+      }
+    }
+    delegates.erase(delegates.begin() + out, delegates.end());
+    infos.resize(out);
+  }
+
+  template <typename Ret, typename... Args>
+  void multicast_delegate<Ret(Args...)>::apply_pending() {
+    // applying a change never invokes a callable, so no new changes can be
+    // queued while this loop runs. A change is only dequeued once it is
+    // applied, i.e. the rest stays queued if applying one throws.
+    struct dequeue_guard {
+      std::vector<pending_change> &pending;
+      size_t                       applied{0};
+      ~dequeue_guard() {
+        pending.erase(pending.begin(), pending.begin() + applied);
+      }
+    } guard{pending};
+    for (; guard.applied < pending.size(); ++guard.applied) {
+      auto &change = pending[guard.applied];
+      switch (change.what) {
+        case pending_change::kind::bind:
+          insert(change.info, std::move(change.del));
+          break;
+        case pending_change::kind::unbind:
+          remove(change.info.sequence);
+          break;
+        case pending_change::kind::reset:
+          clear_callables();
+          break;
+        case pending_change::kind::enable_group:
+          set_group_enabled(change.info.group, true);
+          break;
+        case pending_change::kind::disable_group:
+          set_group_enabled(change.info.group, false);
+          break;
+      }
+    }
+  }
+
+  template <typename Ret, typename... Args>
+  void multicast_delegate<Ret(Args...)>::flush_pending() {
+    if (emit_depth == 0 && !pending.empty())
+      apply_pending();
+  }
+
+  template <typename Ret, typename... Args>
+  size_t multicast_delegate<Ret(Args...)>::find_group(
+      std::string_view group) const {
+    for (size_t i = 0; i < groups.size(); ++i) {
+      if (groups[i].name == group)
+        return i;
+    }
+    return impl::no_group;
+  }
+
+  template <typename Ret, typename... Args>
+  size_t multicast_delegate<Ret(Args...)>::make_group(std::string_view group) {
+    size_t index = find_group(group);
+    if (index == impl::no_group) {
+      index = groups.size();
+      groups.push_back(impl::group_info{std::string(group), true});
+    }
+    return index;
   }
 
   template <typename Ret, typename... Args>
@@ -0,0 +1,305 @@
+/**
+ * \file packed_multicast_delegate.hpp
+ * \author Pele Constam (pelectron1602\gmail.com)
+ * \brief This file defines the \ref pc::packed_multicast_delegate<Ret(Args...)>
+ * class, a multicast delegate storing its callables as a structure of arrays.
+ * \version 0.1
+ * \date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef PC_PACKED_MULTICAST_DELEGATE_HPP
+#define PC_PACKED_MULTICAST_DELEGATE_HPP
+#include "multicast_delegate.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+namespace pc {
+#ifndef GENERATING_DOCUMENTATION
+  /// forward declaration, intentionally left unimplemented.
+  template <typename>
+  class packed_multicast_delegate;
+#endif
+
+  /**
+   * \brief \anchor packed-multicast-delegate-brief a multicast delegate which
+   * stores its callables as a structure of arrays.
+   *
+   * A multicast_delegate stores a vector of delegates, i.e. the storage,
+   * [invoke](#delegate-invoke) and [table](#delegate-table) members of each
+   * callable are interleaved. Only storage and invoke are needed to invoke a
+   * callable. This class splits the three members into three arrays, so
+   * invoking reads two dense arrays and never touches the vtable pointers.
+   *
+   * Additionally, group_by_target() reorders the callables by their invoke
+   * function, so that callables of the same kind, e.g. all free functions or
+   * all instances of the same function object type, are invoked one after
+   * another. Calling the same invoke function repeatedly is much easier on the
+   * indirect branch predictor than a random sequence of targets.
+   *
+   * The results are collected exactly like in a multicast_delegate.
+   *
+   * \tparam Ret return type of the delegate
+   * \tparam Args argument types of the delegate
+   */
+  template <typename Ret, typename... Args>
+  class packed_multicast_delegate<Ret(Args...)> {
+  public:
+    /// single delegate type.
+    using delegate_t = ::pc::delegate<Ret(Args...)>;
+    /// type that stores returned values.
+    using result_storage_t = impl::value_collector<Ret>;
+    /// result iterator type.
+    using result_iterator = typename result_storage_t::iterator;
+    /// const result iterator type.
+    using const_result_iterator = typename result_storage_t::const_iterator;
+    /// value_type of the results vector.
+    using value_type = impl::ret_val_t<Ret>;
+
+    /// default constructor
+    packed_multicast_delegate() = default;
+    /// copy constructor. Copies every callable.
+    packed_multicast_delegate(const packed_multicast_delegate& other);
+    /// move constructor. other is empty after the move.
+    packed_multicast_delegate(packed_multicast_delegate&& other) noexcept;
+    packed_multicast_delegate&
+        operator=(const packed_multicast_delegate&) = delete;
+    /// destructor
+    ~packed_multicast_delegate();
+
+    /// invoke the packed_multicast_delegate
+    void operator()(Args... args);
+
+    /**
+     * \brief bind a callable. The callable is appended.
+     * \tparam BindArgs argument types, see the delegate_t constructors.
+     * \param bind_args arguments to construct the delegate from, i.e. a free
+     * function, an object and member function, a function object or a
+     * delegate.
+     */
+    template <typename... BindArgs>
+    void bind(BindArgs&&... bind_args);
+
+    /**
+     * \brief reorder the callables so that callables with the same invoke
+     * function are adjacent. Callables with the same invoke function keep their
+     * relative order.
+     * \note This changes the order in which the callables are invoked.
+     */
+    void group_by_target();
+
+    /// get the number of callables bound.
+    size_t num_callables() const;
+
+    /// get the number of results stored.
+    size_t num_results() const;
+
+    /// clear the results vector. The callables will be unchanged.
+    void clear_results();
+
+    /// unbind all callables. The results vector will be unchanged.
+    void reset();
+
+    /// get iterator to the beginning of the results array.
+    result_iterator begin();
+    /// get iterator to the end of the results array.
+    result_iterator end();
+    /// get const iterator to the beginning of the results array.
+    const_result_iterator begin() const;
+    /// get const iterator to the end of the results array.
+    const_result_iterator end() const;
+
+  private:
+    /// type of the invoke function pointers.
+    using invoke_t = Ret (*)(void*, impl::param_t<Args>...);
+
+    /// make room for at least n callables.
+    void reserve(size_t n);
+    /// move the callables into storage of the given capacity, placing callable
+    /// i at position order[i].
+    void relocate(size_t new_capacity, const size_t* order);
+
+    std::vector<invoke_t>              invokes; //< hot: read on every call
+    std::unique_ptr<impl::storage_t[]> storages; //< hot: read on every call
+    std::vector<const impl::vtable*>   tables;   //< cold: copy/move/destroy
+    size_t                             capacity{0};
+    [[maybe_unused]] result_storage_t  collector;
+  };
+
+  template <typename Ret, typename... Args>
+  packed_multicast_delegate<Ret(Args...)>::packed_multicast_delegate(
+      const packed_multicast_delegate& other)
+      : collector(other.collector) {
+    reserve(other.tables.size());
+    for (size_t i = 0; i < other.tables.size(); ++i) {
+      other.tables[i]->copy(&storages[i], &other.storages[i]);
+      invokes.push_back(other.invokes[i]);
+      tables.push_back(other.tables[i]);
+    }
+  }
+
+  template <typename Ret, typename... Args>
+  packed_multicast_delegate<Ret(Args...)>::packed_multicast_delegate(
+      packed_multicast_delegate&& other) noexcept
+      : invokes(std::move(other.invokes)), storages(std::move(other.storages)),
+        tables(std::move(other.tables)), capacity(other.capacity),
+        collector(std::move(other.collector)) {
+    other.invokes.clear();
+    other.tables.clear();
+    other.capacity = 0;
+  }
+
+  template <typename Ret, typename... Args>
+  packed_multicast_delegate<Ret(Args...)>::~packed_multicast_delegate() {
+    reset();
+  }
+
+  template <typename Ret, typename... Args>
+  void packed_multicast_delegate<Ret(Args...)>::operator()(Args... args) {
+    const size_t     n = invokes.size();
+    const invoke_t*  invoke = invokes.data();
+    impl::storage_t* storage = storages.get();
+    if constexpr (std::is_same_v<Ret, void>) {
+      for (size_t i = 0; i < n; ++i)
+        invoke[i](&storage[i], args...);
+    } else if constexpr (std::is_rvalue_reference_v<Ret>) {
+      collector.values.reserve(collector.values.size() + n);
+      for (size_t i = 0; i < n; ++i)
+        collector.values.push_back(std::move(invoke[i](&storage[i], args...)));
+    } else {
+      collector.values.reserve(collector.values.size() + n);
+      for (size_t i = 0; i < n; ++i)
+        collector.values.push_back(invoke[i](&storage[i], args...));
+    }
+  }
+
+  template <typename Ret, typename... Args>
+  template <typename... BindArgs>
+  void packed_multicast_delegate<Ret(Args...)>::bind(BindArgs&&... bind_args) {
+    delegate_t   d(std::forward<BindArgs>(bind_args)...);
+    const size_t n = tables.size();
+    reserve(n + 1);
+    // move the callable out of d. Like the move constructor of delegate, the
+    // vtable's move relocates the callable and d is left without destroying
+    // it.
+    const impl::vtable* table = impl::delegate_access::table(d);
+    table->move(&storages[n], &impl::delegate_access::storage(d));
+    invokes.push_back(impl::delegate_access::invoke(d));
+    tables.push_back(table);
+    impl::delegate_access::release(d);
+  }
+
+  template <typename Ret, typename... Args>
+  void packed_multicast_delegate<Ret(Args...)>::group_by_target() {
+    const size_t        n = tables.size();
+    std::vector<size_t> by_target(n);
+    std::iota(by_target.begin(), by_target.end(), size_t{0});
+    std::stable_sort(by_target.begin(), by_target.end(),
+                     [this](size_t a, size_t b) {
+                       return std::less<invoke_t>{}(invokes[a], invokes[b]);
+                     });
+    // by_target[j] is the old index of the callable which goes to j.
+    std::vector<size_t>              order(n);
+    std::vector<invoke_t>            sorted_invokes(n);
+    std::vector<const impl::vtable*> sorted_tables(n);
+    for (size_t j = 0; j < n; ++j) {
+      order[by_target[j]] = j;
+      sorted_invokes[j] = invokes[by_target[j]];
+      sorted_tables[j] = tables[by_target[j]];
+    }
+    relocate(capacity, order.data());
+    invokes = std::move(sorted_invokes);
+    tables = std::move(sorted_tables);
+  }
+
+  template <typename Ret, typename... Args>
+  size_t packed_multicast_delegate<Ret(Args...)>::num_callables() const {
+    return tables.size();
+  }
+
+  template <typename Ret, typename... Args>
+  size_t packed_multicast_delegate<Ret(Args...)>::num_results() const {
+    if constexpr (!std::is_same_v<Ret, void>) {
+      return collector.values.size();
+    } else
+      return 0;
+  }
+
+  template <typename Ret, typename... Args>
+  void packed_multicast_delegate<Ret(Args...)>::clear_results() {
+    if constexpr (!std::is_same_v<Ret, void>) {
+      collector.values.clear();
+    }
+  }
+
+  template <typename Ret, typename... Args>
+  void packed_multicast_delegate<Ret(Args...)>::reset() {
+    for (size_t i = 0; i < tables.size(); ++i)
+      tables[i]->destroy(&storages[i]);
+    invokes.clear();
+    tables.clear();
+  }
+
+  template <typename Ret, typename... Args>
+  void packed_multicast_delegate<Ret(Args...)>::reserve(size_t n) {
+    if (n <= capacity)
+      return;
+    const size_t new_capacity = std::max(n, 2 * capacity);
+    std::vector<size_t> order(tables.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    relocate(new_capacity, order.data());
+  }
+
+  template <typename Ret, typename... Args>
+  void packed_multicast_delegate<Ret(Args...)>::relocate(size_t new_capacity,
+                                                         const size_t* order) {
+    // the callables cannot simply be memcpy'd, an inline stored function
+    // object must be moved with its vtable's move function.
+    auto new_storages = std::make_unique<impl::storage_t[]>(new_capacity);
+    for (size_t i = 0; i < tables.size(); ++i)
+      tables[i]->move(&new_storages[order[i]], &storages[i]);
+    storages = std::move(new_storages);
+    capacity = new_capacity;
+  }
+
+  template <typename Ret, typename... Args>
+  typename packed_multicast_delegate<Ret(Args...)>::result_iterator
+      packed_multicast_delegate<Ret(Args...)>::begin() {
+    static_assert(!std::is_same_v<Ret, void>,
+                  "Cannot call this function with Ret = void.");
+    return collector.values.begin();
+  }
+
+  template <typename Ret, typename... Args>
+  typename packed_multicast_delegate<Ret(Args...)>::result_iterator
+      packed_multicast_delegate<Ret(Args...)>::end() {
+    static_assert(!std::is_same_v<Ret, void>,
+                  "Cannot call this function with Ret = void.");
+    return collector.values.end();
+  }
+
+  template <typename Ret, typename... Args>
+  typename packed_multicast_delegate<Ret(Args...)>::const_result_iterator
+      packed_multicast_delegate<Ret(Args...)>::begin() const {
+    static_assert(!std::is_same_v<Ret, void>,
+                  "Cannot call this function with Ret = void.");
+    return collector.values.begin();
+  }
+
+  template <typename Ret, typename... Args>
+  typename packed_multicast_delegate<Ret(Args...)>::const_result_iterator
+      packed_multicast_delegate<Ret(Args...)>::end() const {
+    static_assert(!std::is_same_v<Ret, void>,
+                  "Cannot call this function with Ret = void.");
+    return collector.values.end();
+  }
+} // namespace pc
+
+#endif
@@ -0,0 +1,272 @@
+/**
+ * \file sharded_multicast_delegate.hpp
+ * \author Pele Constam (pelectron1602\gmail.com)
+ * \brief This file defines the \ref
+ * pc::sharded_multicast_delegate<Ret(Args...)> class, a multicast delegate
+ * which many threads can invoke without sharing cache lines.
+ * \version 0.1
+ * \date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef PC_SHARDED_MULTICAST_DELEGATE_HPP
+#define PC_SHARDED_MULTICAST_DELEGATE_HPP
+#include "delegate.hpp"
+#include "multicast_delegate.hpp"
+
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pc {
+#ifndef GENERATING_DOCUMENTATION
+  /// forward declaration, intentionally left unimplemented.
+  template <typename>
+  class sharded_multicast_delegate;
+#endif
+
+  /**
+   * \brief \anchor sharded-multicast-delegate-brief a multicast delegate for
+   * many threads invoking it at the same time, with one replica of the bound
+   * callables and one results buffer per shard.
+   *
+   * Each thread is assigned a shard on its first invocation, round robin, and
+   * always invokes the replica of its shard and appends the returned values
+   * to the shard's buffer. The shards are cache line aligned, so as long as
+   * there are at least as many shards as invoking threads, invocations share
+   * no written cache line and scale with the number of cores. Each shard has
+   * its own mutex, which is uncontended in that case. Threads sharing a shard
+   * stay correct, but serialize on its mutex.
+   *
+   * bind(), unbind() and reset() update every replica and are therefore
+   * considerably more expensive than invocations. The returned values are
+   * merged on demand by take_results(), shard by shard: the values of one
+   * thread keep their order, but the values of different threads are not
+   * ordered relative to each other.
+   *
+   * \note Every replica holds its own copy of each callable. Function objects
+   * with state are therefore copied once per shard; share state through a
+   * pointer or bind a member function instead.
+   * \note A callable must not bind, unbind or reset the
+   * sharded_multicast_delegate it is invoked from.
+   *
+   * \tparam Ret return type of the delegate
+   * \tparam Args argument types of the delegate
+   */
+  template <typename Ret, typename... Args>
+  class sharded_multicast_delegate<Ret(Args...)> {
+  public:
+    /// single delegate type.
+    using delegate_t = ::pc::delegate<Ret(Args...)>;
+    /// value_type of the results.
+    using value_type = impl::ret_val_t<Ret>;
+    /// identifies a bound callable. Returned by bind().
+    using subscription_id = size_t;
+
+    /**
+     * \brief construct with num_shards shards.
+     * \param num_shards number of shards. Defaults to the number of hardware
+     * threads.
+     */
+    explicit sharded_multicast_delegate(
+        size_t num_shards = default_num_shards());
+    sharded_multicast_delegate(const sharded_multicast_delegate&) = delete;
+    sharded_multicast_delegate&
+        operator=(const sharded_multicast_delegate&) = delete;
+
+    /// invoke the replica of the calling thread's shard.
+    void operator()(Args... args);
+
+    /**
+     * \brief bind a callable to every replica.
+     * \tparam BindArgs argument types, see the delegate_t constructors.
+     * \param bind_args arguments to construct the delegate from, i.e. a free
+     * function, an object and member function, a function object or a
+     * delegate.
+     * \return subscription_id id to pass to unbind()
+     */
+    template <typename... BindArgs>
+    subscription_id bind(BindArgs&&... bind_args);
+
+    /**
+     * \brief unbind a callable from every replica.
+     * \param id id returned by bind()
+     * \return true the callable was unbound
+     * \return false no callable with this id is bound
+     */
+    bool unbind(subscription_id id);
+
+    /// unbind all callables.
+    void reset();
+
+    /// get the number of callables bound.
+    size_t num_callables() const;
+
+    /// get the number of values in the results buffers of all shards.
+    size_t num_results() const;
+
+    /**
+     * \brief move the values out of the results buffers of all shards.
+     * \return std::vector<value_type> the values, shard by shard
+     */
+    std::vector<value_type> take_results();
+
+    /// clear the results buffers of all shards.
+    void clear_results();
+
+    /// get the number of shards.
+    size_t num_shards() const { return shards.size(); }
+
+    /// get the default number of shards, i.e. the number of hardware threads.
+    static size_t default_num_shards();
+
+  private:
+    /// a replica of the callables and its results buffer.
+    struct alignas(impl::cache_line_size) shard {
+      mutable std::mutex           mutex;
+      std::vector<delegate_t>      delegates;
+      std::vector<subscription_id> ids; //< parallel to delegates
+      impl::value_collector<Ret>   collector;
+    };
+
+    /// get the shard of the calling thread.
+    shard& this_thread_shard();
+
+    std::vector<std::unique_ptr<shard>> shards;
+    std::mutex                          writer_mutex;
+    subscription_id                     next_id{0};
+  };
+
+  template <typename Ret, typename... Args>
+  sharded_multicast_delegate<Ret(Args...)>::sharded_multicast_delegate(
+      size_t num_shards) {
+    num_shards = num_shards == 0 ? 1 : num_shards;
+    for (size_t i = 0; i < num_shards; ++i)
+      shards.push_back(std::make_unique<shard>());
+  }
+
+  template <typename Ret, typename... Args>
+  void sharded_multicast_delegate<Ret(Args...)>::operator()(Args... args) {
+    shard&                      s = this_thread_shard();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if constexpr (std::is_same_v<Ret, void>) {
+      for (auto& del : s.delegates)
+        del(args...);
+    } else {
+      for (auto& del : s.delegates)
+        s.collector.values.push_back(del(args...));
+    }
+  }
+
+  template <typename Ret, typename... Args>
+  template <typename... BindArgs>
+  typename sharded_multicast_delegate<Ret(Args...)>::subscription_id
+      sharded_multicast_delegate<Ret(Args...)>::bind(BindArgs&&... bind_args) {
+    // construct the delegate outside of the locks.
+    const delegate_t            d(std::forward<BindArgs>(bind_args)...);
+    std::lock_guard<std::mutex> writer_lock(writer_mutex);
+    const subscription_id       id = next_id++;
+    for (auto& s : shards) {
+      std::lock_guard<std::mutex> lock(s->mutex);
+      s->delegates.push_back(d);
+      s->ids.push_back(id);
+    }
+    return id;
+  }
+
+  template <typename Ret, typename... Args>
+  bool sharded_multicast_delegate<Ret(Args...)>::unbind(subscription_id id) {
+    std::lock_guard<std::mutex> writer_lock(writer_mutex);
+    bool                        found = false;
+    for (auto& s : shards) {
+      std::lock_guard<std::mutex> lock(s->mutex);
+      for (size_t i = 0; i < s->ids.size(); ++i) {
+        if (s->ids[i] == id) {
+          s->ids.erase(s->ids.begin() + i);
+          s->delegates.erase(s->delegates.begin() + i);
+          found = true;
+          break;
+        }
+      }
+    }
+    return found;
+  }
+
+  template <typename Ret, typename... Args>
+  void sharded_multicast_delegate<Ret(Args...)>::reset() {
+    std::lock_guard<std::mutex> writer_lock(writer_mutex);
+    for (auto& s : shards) {
+      std::lock_guard<std::mutex> lock(s->mutex);
+      s->delegates.clear();
+      s->ids.clear();
+    }
+  }
+
+  template <typename Ret, typename... Args>
+  size_t sharded_multicast_delegate<Ret(Args...)>::num_callables() const {
+    std::lock_guard<std::mutex> lock(shards.front()->mutex);
+    return shards.front()->delegates.size();
+  }
+
+  template <typename Ret, typename... Args>
+  size_t sharded_multicast_delegate<Ret(Args...)>::num_results() const {
+    static_assert(!std::is_same_v<Ret, void>,
+                  "Cannot call this function with Ret = void.");
+    size_t n = 0;
+    for (auto& s : shards) {
+      std::lock_guard<std::mutex> lock(s->mutex);
+      n += s->collector.values.size();
+    }
+    return n;
+  }
+
+  template <typename Ret, typename... Args>
+  auto sharded_multicast_delegate<Ret(Args...)>::take_results()
+      -> std::vector<value_type> {
+    static_assert(!std::is_same_v<Ret, void>,
+                  "Cannot call this function with Ret = void.");
+    std::vector<value_type> merged;
+    merged.reserve(num_results());
+    for (auto& s : shards) {
+      std::lock_guard<std::mutex> lock(s->mutex);
+      auto& values = s->collector.values;
+      std::move(values.begin(), values.end(), std::back_inserter(merged));
+      values.clear();
+    }
+    return merged;
+  }
+
+  template <typename Ret, typename... Args>
+  void sharded_multicast_delegate<Ret(Args...)>::clear_results() {
+    static_assert(!std::is_same_v<Ret, void>,
+                  "Cannot call this function with Ret = void.");
+    for (auto& s : shards) {
+      std::lock_guard<std::mutex> lock(s->mutex);
+      s->collector.values.clear();
+    }
+  }
+
+  template <typename Ret, typename... Args>
+  size_t sharded_multicast_delegate<Ret(Args...)>::default_num_shards() {
+    const size_t n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+  }
+
+  template <typename Ret, typename... Args>
+  typename sharded_multicast_delegate<Ret(Args...)>::shard&
+      sharded_multicast_delegate<Ret(Args...)>::this_thread_shard() {
+    // assigned once per thread, shared by all instances.
+    static std::atomic<size_t> next_thread{0};
+    thread_local const size_t  thread_index =
+        next_thread.fetch_add(1, std::memory_order_relaxed);
+    return *shards[thread_index % shards.size()];
+  }
+} // namespace pc
+
+#endif
@@ -0,0 +1,207 @@
+/**
+ * \file static_multicast.hpp
+ * \author Pele Constam (pelectron1602\gmail.com)
+ * \brief This file defines the \ref pc::static_multicast<Ret(Args...),
+ * Callables...> class, a multicast delegate whose callables are fixed at
+ * compile time.
+ * \version 0.1
+ * \date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef PC_STATIC_MULTICAST_HPP
+#define PC_STATIC_MULTICAST_HPP
+#include "multicast_delegate.hpp"
+
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace pc {
+#ifndef GENERATING_DOCUMENTATION
+  /// forward declaration, intentionally left unimplemented.
+  template <typename, typename...>
+  class static_multicast;
+#endif
+
+  /**
+   * \brief \anchor static-multicast-brief a multicast delegate with a fixed set
+   * of callables.
+   *
+   * The callables are stored by value in a tuple and invoked in order with a
+   * fold expression. There is no type erasure, so the compiler sees every call
+   * and can inline it. In exchange, callables can neither be bound nor
+   * unbound after construction.
+   *
+   * The returned values are collected exactly like in a multicast_delegate,
+   * i.e. each invocation appends one value per callable to the results, which
+   * are accessed with begin() and end(), or cbegin() and cend(). This makes static_multicast a drop in
+   * replacement for a multicast_delegate whose callables never change.
+   *
+   * \tparam Ret return type of the delegate
+   * \tparam Args argument types of the delegate
+   * \tparam Callables types of the callables. Each must be invocable with
+   * Args... and return a type convertible to Ret.
+   */
+  template <typename Ret, typename... Args, typename... Callables>
+  class static_multicast<Ret(Args...), Callables...> {
+    static_assert((std::is_invocable_r_v<Ret, Callables&, Args...> && ...),
+                  "every callable must be invocable with Args... and return "
+                  "a type convertible to Ret.");
+
+  public:
+    /// type that stores returned values.
+    using result_storage_t = impl::value_collector<Ret>;
+    /// result iterator type.
+    using result_iterator = typename result_storage_t::iterator;
+    /// const result iterator type.
+    using const_result_iterator = typename result_storage_t::const_iterator;
+    /// value_type of the results vector.
+    using value_type = impl::ret_val_t<Ret>;
+
+    /**
+     * \brief construct from the callables.
+     * \param callables callables, invoked in the given order.
+     */
+    explicit static_multicast(Callables... callables);
+
+    /// invoke the static_multicast
+    void operator()(Args... args);
+
+    /// get the number of callables.
+    static constexpr size_t num_callables() { return sizeof...(Callables); }
+
+    /// get the number of results stored.
+    size_t num_results() const;
+
+    /// clear the results vector.
+    void clear_results();
+
+    /// get the callable at index I.
+    template <size_t I>
+    auto& get();
+
+    /// get iterator to the beginning of the results array.
+    result_iterator begin();
+    /// get iterator to the end of the results array.
+    result_iterator end();
+    /// get const iterator to the beginning of the results array.
+    const_result_iterator begin() const;
+    /// get const iterator to the end of the results array.
+    const_result_iterator end() const;
+    /// get const iterator to the beginning of the results array.
+    const_result_iterator cbegin() const;
+    /// get const iterator to the end of the results array.
+    const_result_iterator cend() const;
+
+  private:
+    std::tuple<Callables...>          callables;
+    [[maybe_unused]] result_storage_t collector;
+  };
+
+  /**
+   * \brief create a static_multicast with the signature Signature from
+   * callables, deducing their types.
+   * \tparam Signature signature of the static_multicast, i.e. Ret(Args...)
+   * \param callables callables, invoked in the given order.
+   */
+  template <typename Signature, typename... Callables>
+  static_multicast<Signature, std::decay_t<Callables>...>
+      make_static_multicast(Callables&&... callables) {
+    return static_multicast<Signature, std::decay_t<Callables>...>(
+        std::forward<Callables>(callables)...);
+  }
+
+  template <typename Ret, typename... Args, typename... Callables>
+  static_multicast<Ret(Args...), Callables...>::static_multicast(
+      Callables... callables)
+      : callables(std::move(callables)...) {}
+
+  template <typename Ret, typename... Args, typename... Callables>
+  void static_multicast<Ret(Args...), Callables...>::operator()(Args... args) {
+    std::apply(
+        [&](Callables&... c) {
+          if constexpr (std::is_same_v<Ret, void>) {
+            (static_cast<void>(std::invoke(c, args...)), ...);
+          } else {
+            collector.values.reserve(collector.values.size() +
+                                     sizeof...(Callables));
+            (collector.values.push_back(
+                 static_cast<Ret>(std::invoke(c, args...))),
+             ...);
+          }
+        },
+        callables);
+  }
+
+  template <typename Ret, typename... Args, typename... Callables>
+  size_t static_multicast<Ret(Args...), Callables...>::num_results() const {
+    if constexpr (!std::is_same_v<Ret, void>) {
+      return collector.values.size();
+    } else
+      return 0;
+  }
+
+  template <typename Ret, typename... Args, typename... Callables>
+  void static_multicast<Ret(Args...), Callables...>::clear_results() {
+    if constexpr (!std::is_same_v<Ret, void>) {
+      collector.values.clear();
+    }
+  }
+
+  template <typename Ret, typename... Args, typename... Callables>
+  template <size_t I>
+  auto& static_multicast<Ret(Args...), Callables...>::get() {
+    return std::get<I>(callables);
+  }
+
+  template <typename Ret, typename... Args, typename... Callables>
+  typename static_multicast<Ret(Args...), Callables...>::result_iterator
+      static_multicast<Ret(Args...), Callables...>::begin() {
+    static_assert(!std::is_same_v<Ret, void>,
+                  "Cannot call this function with Ret = void.");
+    return collector.values.begin();
+  }
+
+  template <typename Ret, typename... Args, typename... Callables>
+  typename static_multicast<Ret(Args...), Callables...>::result_iterator
+      static_multicast<Ret(Args...), Callables...>::end() {
+    static_assert(!std::is_same_v<Ret, void>,
+                  "Cannot call this function with Ret = void.");
+    return collector.values.end();
+  }
+
+  template <typename Ret, typename... Args, typename... Callables>
+  typename static_multicast<Ret(Args...), Callables...>::const_result_iterator
+      static_multicast<Ret(Args...), Callables...>::begin() const {
+    static_assert(!std::is_same_v<Ret, void>,
+                  "Cannot call this function with Ret = void.");
+    return collector.values.begin();
+  }
+
+  template <typename Ret, typename... Args, typename... Callables>
+  typename static_multicast<Ret(Args...), Callables...>::const_result_iterator
+      static_multicast<Ret(Args...), Callables...>::end() const {
+    static_assert(!std::is_same_v<Ret, void>,
+                  "Cannot call this function with Ret = void.");
+    return collector.values.end();
+  }
+
+  template <typename Ret, typename... Args, typename... Callables>
+  typename static_multicast<Ret(Args...), Callables...>::const_result_iterator
+      static_multicast<Ret(Args...), Callables...>::cbegin() const {
+    return begin();
+  }
+
+  template <typename Ret, typename... Args, typename... Callables>
+  typename static_multicast<Ret(Args...), Callables...>::const_result_iterator
+      static_multicast<Ret(Args...), Callables...>::cend() const {
+    return end();
+  }
+} // namespace pc
+
+#endif
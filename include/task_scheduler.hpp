@@ -0,0 +1,627 @@
+/**
+ * \file task_scheduler.hpp
+ * \author Pele Constam (pelectron1602\gmail.com)
+ * \brief This file defines the \ref pc::task_scheduler class, a fork-join
+ * scheduler with per worker Chase-Lev deques, and the \ref pc::wait_group
+ * class used to wait for spawned tasks.
+ * \version 0.1
+ * \date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef PC_TASK_SCHEDULER_HPP
+#define PC_TASK_SCHEDULER_HPP
+#include "call_queue.hpp"
+#include "delegate.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#ifndef PC_DELEGATE_NO_EXCEPTIONS
+#include <exception>
+#endif
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace pc {
+  class task_scheduler;
+
+  /**
+   * \brief counts the unfinished tasks spawned into it, and keeps the first
+   * exception thrown by one of them. See task_scheduler::wait().
+   */
+  class wait_group {
+  public:
+    wait_group() = default;
+    wait_group(const wait_group&) = delete;
+    wait_group& operator=(const wait_group&) = delete;
+
+    /// add n unfinished tasks.
+    void add(size_t n = 1) { pending.fetch_add(n, std::memory_order_relaxed); }
+
+    /// mark one task as finished.
+    void done() { pending.fetch_sub(1, std::memory_order_release); }
+
+    /// get the number of unfinished tasks.
+    size_t count() const { return pending.load(std::memory_order_acquire); }
+
+  private:
+    friend class task_scheduler;
+
+#ifndef PC_DELEGATE_NO_EXCEPTIONS
+    /// keep e if it is the first exception of a task of this group. Called
+    /// before the task is marked as finished.
+    void fail(std::exception_ptr e) {
+      if (!failed.exchange(true, std::memory_order_relaxed))
+        error = std::move(e);
+    }
+
+    /// rethrow and clear the kept exception, if any. Only called once all
+    /// tasks are finished.
+    void rethrow_if_failed() {
+      if (!failed.load(std::memory_order_relaxed))
+        return;
+      std::exception_ptr e = std::exchange(error, nullptr);
+      failed.store(false, std::memory_order_relaxed);
+      std::rethrow_exception(e);
+    }
+
+    std::atomic<bool>  failed{false};
+    std::exception_ptr error; //< first exception of a task
+#endif
+    std::atomic<size_t> pending{0};
+  };
+
+  namespace impl {
+    /// \anchor task_storage_size
+    /// bytes available in a task for a callable and its arguments.
+    static constexpr size_t task_storage_size = 96u;
+
+    /**
+     * \brief a spawned task. The callable and its arguments are stored in
+     * place as an impl::deferred_call. Tasks are recycled through free lists,
+     * so spawning only allocates when a free list runs dry.
+     */
+    struct alignas(cache_line_size) task_node {
+      void (*run)(void* storage, bool invoke);
+      wait_group* group; //< finished when the task has run, may be nullptr
+      task_node*  next;  //< free list link
+      size_t      owner; //< index of the free list the task belongs to
+      alignas(16) unsigned char storage[task_storage_size];
+    };
+
+    /**
+     * \brief bounded Chase-Lev work stealing deque of pointers.
+     *
+     * The owning thread pushes and pops at the bottom, other threads steal
+     * from the top. Only the last element is contended, which is resolved with
+     * a compare and swap on the top index. The memory orderings follow Lê et
+     * al., "Correct and Efficient Work-Stealing for Weak Memory Models".
+     *
+     * \tparam T element type, the deque stores T*.
+     */
+    template <typename T>
+    class work_stealing_deque {
+    public:
+      /// construct with capacity slots, rounded up to a power of two.
+      explicit work_stealing_deque(size_t capacity) {
+        size_t n = 1;
+        while (n < capacity)
+          n *= 2;
+        mask = n - 1;
+        buffer = std::make_unique<std::atomic<T*>[]>(n);
+      }
+
+      /// push x to the bottom. Owner only.
+      /// \return false the deque is full
+      bool push(T* x) {
+        const std::int64_t b = bottom.load(std::memory_order_relaxed);
+        const std::int64_t t = top.load(std::memory_order_acquire);
+        if (b - t > static_cast<std::int64_t>(mask))
+          return false;
+        buffer[b & mask].store(x, std::memory_order_relaxed);
+        bottom.store(b + 1, std::memory_order_release);
+        return true;
+      }
+
+      /// pop from the bottom. Owner only.
+      /// \return the element, or nullptr if the deque is empty
+      T* pop() {
+        const std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+          bottom.store(b + 1, std::memory_order_relaxed);
+          return nullptr;
+        }
+        T* x = buffer[b & mask].load(std::memory_order_relaxed);
+        if (t == b) {
+          // last element, race against the thieves for it.
+          if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                           std::memory_order_relaxed))
+            x = nullptr;
+          bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return x;
+      }
+
+      /// steal from the top. Any thread.
+      /// \return the element, or nullptr if the deque is empty or another
+      /// thread won the race for the element.
+      T* steal() {
+        std::int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b)
+          return nullptr;
+        T* x = buffer[t & mask].load(std::memory_order_relaxed);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                         std::memory_order_relaxed))
+          return nullptr;
+        return x;
+      }
+
+    private:
+      alignas(cache_line_size) std::atomic<std::int64_t> top{0};
+      alignas(cache_line_size) std::atomic<std::int64_t> bottom{0};
+      std::unique_ptr<std::atomic<T*>[]> buffer;
+      size_t                             mask;
+    };
+  } // namespace impl
+
+  /**
+   * \brief \anchor task-scheduler-brief a work stealing fork-join scheduler.
+   *
+   * Each worker owns a Chase-Lev deque. Tasks spawned by a worker are pushed
+   * to the bottom of its own deque and popped from there again, newest
+   * first, while idle workers steal the oldest tasks from the top of the
+   * other deques. Tasks spawned by other threads go to a shared injection
+   * queue.
+   *
+   * A task is a callable plus its arguments, stored in place in a recycled
+   * task object of [task_storage_size](#task_storage_size) (96) bytes, e.g. a
+   * delegate<void()> or a lambda with up to twelve pointer sized captures.
+   * Spawning therefore does not allocate once the scheduler is warmed up.
+   * Tasks are only moved, never copied, so move-only callables work as well.
+   *
+   * To wait for tasks, spawn them into a \ref pc::wait_group and call wait().
+   * Waiting runs other tasks instead of blocking, so tasks can spawn and wait
+   * for their own subtasks:
+   * \code{.cpp}
+   * long fib(pc::task_scheduler& s, int n) {
+   *   if (n < 2)
+   *     return n;
+   *   pc::wait_group wg;
+   *   long           a;
+   *   s.spawn(wg, [&s, &a, n] { a = fib(s, n - 1); });
+   *   const long b = fib(s, n - 2);
+   *   s.wait(wg);
+   *   return a + b;
+   * }
+   * \endcode
+   *
+   * If a task spawned into a wait_group throws, the first exception is kept
+   * in the group and rethrown by wait() once all tasks of the group are
+   * finished. The exception of a task without a group propagates out of
+   * whichever call runs it, i.e. try_run_one() or spawn(), or terminates the
+   * program if a worker thread runs it, like that of a std::thread. Either
+   * way, the task is recycled and counts as finished.
+   *
+   * The task_scheduler is an executor in the sense of
+   * multicast_delegate::parallel_invoke(), i.e. it provides submit(),
+   * try_run_one() and num_workers().
+   */
+  class task_scheduler {
+  public:
+    /**
+     * \brief construct and start the worker threads.
+     * \param num_threads number of worker threads. Defaults to the number of
+     * hardware threads.
+     */
+    explicit task_scheduler(size_t num_threads = default_num_threads());
+    task_scheduler(const task_scheduler&) = delete;
+    task_scheduler& operator=(const task_scheduler&) = delete;
+
+    /// destructor. Runs all spawned tasks and joins the worker threads.
+    ~task_scheduler();
+
+    /**
+     * \brief spawn a task which calls f with args. f and args are decay
+     * copied into the task.
+     * \param f callable
+     * \param args arguments
+     */
+    template <typename F, typename... CallArgs,
+              std::enable_if_t<!std::is_same_v<std::decay_t<F>, wait_group>>* =
+                  nullptr>
+    void spawn(F&& f, CallArgs&&... args);
+
+    /**
+     * \brief spawn a task into a wait_group. The task counts as unfinished
+     * until it has run.
+     * \param group wait_group, must outlive the task.
+     * \param f callable
+     * \param args arguments
+     */
+    template <typename F, typename... CallArgs>
+    void spawn(wait_group& group, F&& f, CallArgs&&... args);
+
+    /**
+     * \brief run tasks on the calling thread until all tasks of group are
+     * finished.
+     * \param group the wait_group
+     * \throws the first exception thrown by a task of group, if any.
+     */
+    void wait(wait_group& group);
+
+    /**
+     * \brief call body(begin, end) for consecutive chunks of [first, last).
+     * The range is split in halves recursively, and the halves are spawned,
+     * until the chunks are at most grain elements long. Returns when all
+     * chunks are done.
+     * \param first first index
+     * \param last one past the last index
+     * \param grain maximum chunk length. 0 picks a length which gives each
+     * thread about eight chunks.
+     * \param body callable with signature void(size_t begin, size_t end)
+     */
+    template <typename F>
+    void parallel_for(size_t first, size_t last, size_t grain, F&& body);
+
+    /**
+     * \brief spawn a delegate<void()>. Makes the task_scheduler an executor
+     * for multicast_delegate::parallel_invoke().
+     * \param task task to run
+     */
+    void submit(delegate<void()> task);
+
+    /**
+     * \brief run one pending task on the calling thread.
+     * \return true a task was run
+     * \return false no task was pending
+     */
+    bool try_run_one();
+
+    /// get the number of worker threads.
+    size_t num_workers() const;
+
+    /// number of hardware threads, at least 1.
+    static size_t default_num_threads();
+
+  private:
+    /// number of tasks allocated at once when a free list runs dry.
+    static constexpr size_t tasks_per_block = 64u;
+    /// capacity of a worker's deque. A worker runs tasks spawned into a full
+    /// deque right away.
+    static constexpr size_t deque_capacity = 4096u;
+
+    /// a free list of tasks. Tasks are only taken by the owning thread, but
+    /// released by whichever thread ran them.
+    struct task_pool {
+      impl::task_node* free{nullptr}; //< owner only
+      std::atomic<impl::task_node*> remote_free{nullptr}; //< other threads
+      std::vector<std::unique_ptr<impl::task_node[]>> blocks;
+    };
+
+    /// per worker state, on its own cache lines.
+    struct alignas(impl::cache_line_size) worker {
+      worker() : deque(deque_capacity) {}
+      impl::work_stealing_deque<impl::task_node> deque;
+      task_pool                                  pool;
+    };
+
+    /// main function of the worker threads.
+    void worker_loop(size_t index);
+    /// find a task for the thread with the given index.
+    impl::task_node* find_task(size_t index);
+    /// take a task from pool, index is the pool's index.
+    impl::task_node* take_task(task_pool& pool, size_t index);
+    /// construct the call to f with args in a new task.
+    template <typename F, typename... CallArgs>
+    void push_task(wait_group* group, F&& f, CallArgs&&... args);
+    /// run a task and hand it back to its pool, even if it throws.
+    void run_task(impl::task_node* task, size_t index);
+    /// hand a task back to its pool and finish its group.
+    void finish_task(impl::task_node* task, size_t index);
+    /// wake a sleeping worker after a task was made available.
+    void notify_one();
+    /// get the pool a task belongs to.
+    task_pool& pool_of(size_t index);
+    /// index of the calling thread's worker, or num_workers() if the calling
+    /// thread is not a worker of this scheduler.
+    size_t this_thread_index() const;
+
+    /// the scheduler and worker index of the worker thread executing this.
+    struct worker_id {
+      const task_scheduler* scheduler{nullptr};
+      size_t                index{0};
+    };
+    static worker_id& this_worker();
+
+    std::vector<std::unique_ptr<worker>> workers;
+    std::vector<std::thread>             threads;
+    std::mutex                           inject_mutex; //< guards the below
+    std::deque<impl::task_node*>         injected;     //< from other threads
+    task_pool                            external_pool;
+    alignas(impl::cache_line_size) std::atomic<size_t> num_pending{0};
+    std::atomic<size_t>                                num_sleeping{0};
+    std::mutex                                         sleep_mutex;
+    std::condition_variable                            wake;
+    bool                                               stopping{false};
+  };
+
+  template <typename F, typename... CallArgs,
+            std::enable_if_t<!std::is_same_v<std::decay_t<F>, wait_group>>*>
+  void task_scheduler::spawn(F&& f, CallArgs&&... args) {
+    push_task(nullptr, std::forward<F>(f), std::forward<CallArgs>(args)...);
+  }
+
+  template <typename F, typename... CallArgs>
+  void task_scheduler::spawn(wait_group& group, F&& f, CallArgs&&... args) {
+    push_task(&group, std::forward<F>(f), std::forward<CallArgs>(args)...);
+  }
+
+  template <typename F>
+  void task_scheduler::parallel_for(size_t first, size_t last, size_t grain,
+                                    F&& body) {
+    if (first >= last)
+      return;
+    if (grain == 0)
+      grain = std::max<size_t>(1, (last - first) / (8 * (num_workers() + 1)));
+
+    // splits its range until it is at most grain long, spawning the upper
+    // halves.
+    struct range_task {
+      task_scheduler*             scheduler;
+      wait_group*                 group;
+      std::remove_reference_t<F>* body;
+      size_t                      grain;
+      void operator()(size_t begin, size_t end) const {
+        while (end - begin > grain) {
+          const size_t mid = begin + (end - begin) / 2;
+          scheduler->spawn(*group, *this, mid, end);
+          end = mid;
+        }
+        (*body)(begin, end);
+      }
+    };
+    wait_group group;
+    // the spawned chunks refer to group, i.e. wait for them even if the part
+    // run here throws.
+#ifdef PC_DELEGATE_NO_EXCEPTIONS
+    range_task{this, &group, &body, grain}(first, last);
+#else
+    try {
+      range_task{this, &group, &body, grain}(first, last);
+    } catch (...) {
+      group.fail(std::current_exception());
+    }
+#endif
+    wait(group);
+  }
+
+  template <typename F, typename... CallArgs>
+  void task_scheduler::push_task(wait_group* group, F&& f,
+                                 CallArgs&&... args) {
+    using call_t =
+        impl::deferred_call<std::decay_t<F>, std::decay_t<CallArgs>...>;
+    static_assert(std::is_invocable_v<std::decay_t<F>,
+                                      std::decay_t<CallArgs>...>,
+                  "f must be invocable with args.");
+    static_assert(sizeof(call_t) <= impl::task_storage_size,
+                  "the callable and its arguments do not fit into a task.");
+    static_assert(alignof(call_t) <= 16,
+                  "the callable or an argument is over aligned.");
+
+    const size_t index = this_thread_index();
+    // tasks from other threads share the external pool and injection queue.
+    std::unique_lock<std::mutex> lock(inject_mutex, std::defer_lock);
+    if (index == workers.size())
+      lock.lock();
+    impl::task_node* task = take_task(pool_of(index), index);
+    ::new (static_cast<void*>(task->storage))
+        call_t{std::forward<F>(f), std::tuple<std::decay_t<CallArgs>...>(
+                                       std::forward<CallArgs>(args)...)};
+    task->run = &impl::run_deferred_call<call_t>;
+    task->group = group;
+    if (group != nullptr)
+      group->add();
+    // num_pending is incremented before the task is published, so it never
+    // drops below the number of tasks which can be found.
+    num_pending.fetch_add(1, std::memory_order_seq_cst);
+    if (index == workers.size()) {
+      injected.push_back(task);
+      lock.unlock();
+    } else if (!workers[index]->deque.push(task)) {
+      num_pending.fetch_sub(1, std::memory_order_relaxed);
+      run_task(task, index);
+      return;
+    }
+    notify_one();
+  }
+
+  inline task_scheduler::task_scheduler(size_t num_threads) {
+    num_threads = num_threads == 0 ? 1 : num_threads;
+    for (size_t i = 0; i < num_threads; ++i)
+      workers.push_back(std::make_unique<worker>());
+    for (size_t i = 0; i < num_threads; ++i)
+      threads.emplace_back([this, i] { worker_loop(i); });
+  }
+
+  inline task_scheduler::~task_scheduler() {
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex);
+      stopping = true;
+    }
+    wake.notify_all();
+    for (auto& t : threads)
+      t.join();
+  }
+
+  inline void task_scheduler::wait(wait_group& group) {
+    while (group.count() != 0) {
+      if (!try_run_one())
+        std::this_thread::yield();
+    }
+#ifndef PC_DELEGATE_NO_EXCEPTIONS
+    group.rethrow_if_failed();
+#endif
+  }
+
+  inline void task_scheduler::submit(delegate<void()> task) {
+    spawn(std::move(task));
+  }
+
+  inline bool task_scheduler::try_run_one() {
+    const size_t     index = this_thread_index();
+    impl::task_node* task = find_task(index);
+    if (task == nullptr)
+      return false;
+    run_task(task, index);
+    return true;
+  }
+
+  inline size_t task_scheduler::num_workers() const { return threads.size(); }
+
+  inline size_t task_scheduler::default_num_threads() {
+    const size_t n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+  }
+
+  inline void task_scheduler::worker_loop(size_t index) {
+    this_worker() = worker_id{this, index};
+    while (true) {
+      if (impl::task_node* task = find_task(index)) {
+        run_task(task, index);
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(sleep_mutex);
+      // announcing the sleep before checking num_pending pairs with
+      // push_task() incrementing num_pending before checking num_sleeping.
+      // One of the two sees the other's increment.
+      num_sleeping.fetch_add(1, std::memory_order_seq_cst);
+      wake.wait(lock, [this] {
+        return stopping ||
+               num_pending.load(std::memory_order_seq_cst) != 0;
+      });
+      num_sleeping.fetch_sub(1, std::memory_order_relaxed);
+      if (stopping && num_pending.load(std::memory_order_acquire) == 0)
+        return;
+    }
+  }
+
+  inline impl::task_node* task_scheduler::find_task(size_t index) {
+    // own deque first, then the other deques and the injection queue.
+    impl::task_node* task = nullptr;
+    for (size_t i = 0; task == nullptr && i <= workers.size(); ++i) {
+      const size_t victim = (index + i) % (workers.size() + 1);
+      if (victim == index && index != workers.size()) {
+        task = workers[victim]->deque.pop();
+      } else if (victim != workers.size()) {
+        task = workers[victim]->deque.steal();
+      } else if (num_pending.load(std::memory_order_relaxed) != 0) {
+        std::lock_guard<std::mutex> lock(inject_mutex);
+        if (!injected.empty()) {
+          task = injected.front();
+          injected.pop_front();
+        }
+      }
+    }
+    if (task != nullptr)
+      num_pending.fetch_sub(1, std::memory_order_relaxed);
+    return task;
+  }
+
+  inline impl::task_node* task_scheduler::take_task(task_pool& pool,
+                                                    size_t     index) {
+    if (pool.free == nullptr)
+      pool.free = pool.remote_free.exchange(nullptr, std::memory_order_acquire);
+    if (pool.free == nullptr) {
+      auto block = std::make_unique<impl::task_node[]>(tasks_per_block);
+      for (size_t i = 0; i < tasks_per_block; ++i) {
+        block[i].owner = index;
+        block[i].next = i + 1 < tasks_per_block ? &block[i + 1] : nullptr;
+      }
+      pool.free = &block[0];
+      pool.blocks.push_back(std::move(block));
+    }
+    impl::task_node* task = pool.free;
+    pool.free = task->next;
+    return task;
+  }
+
+  inline void task_scheduler::run_task(impl::task_node* task, size_t index) {
+    struct finish_guard {
+      task_scheduler&  scheduler;
+      impl::task_node* task;
+      size_t           index;
+      ~finish_guard() { scheduler.finish_task(task, index); }
+    } guard{*this, task, index};
+#ifdef PC_DELEGATE_NO_EXCEPTIONS
+    task->run(task->storage, true);
+#else
+    try {
+      task->run(task->storage, true);
+    } catch (...) {
+      if (task->group == nullptr)
+        throw;
+      task->group->fail(std::current_exception());
+    }
+#endif
+  }
+
+  inline void task_scheduler::finish_task(impl::task_node* task,
+                                          size_t           index) {
+    wait_group* group = task->group;
+    // hand the task back before finishing the group, a waiting thread may
+    // destroy the scheduler right after.
+    task_pool& pool = pool_of(task->owner);
+    if (task->owner == index && index != workers.size()) {
+      task->next = pool.free;
+      pool.free = task;
+    } else {
+      task->next = pool.remote_free.load(std::memory_order_relaxed);
+      while (!pool.remote_free.compare_exchange_weak(
+          task->next, task, std::memory_order_release,
+          std::memory_order_relaxed)) {
+      }
+    }
+    if (group != nullptr)
+      group->done();
+  }
+
+  inline void task_scheduler::notify_one() {
+    if (num_sleeping.load(std::memory_order_seq_cst) == 0)
+      return;
+    // taking the mutex makes sure a worker which just found nothing to do is
+    // either already waiting or will see num_pending != 0.
+    { std::lock_guard<std::mutex> lock(sleep_mutex); }
+    wake.notify_one();
+  }
+
+  inline task_scheduler::task_pool& task_scheduler::pool_of(size_t index) {
+    return index == workers.size() ? external_pool : workers[index]->pool;
+  }
+
+  inline size_t task_scheduler::this_thread_index() const {
+    const worker_id& id = this_worker();
+    return id.scheduler == this ? id.index : workers.size();
+  }
+
+  inline task_scheduler::worker_id& task_scheduler::this_worker() {
+    thread_local worker_id id;
+    return id;
+  }
+} // namespace pc
+
+#endif
@@ -0,0 +1,233 @@
+/**
+ * \file thread_pool.hpp
+ * \author Pele Constam (pelectron1602\gmail.com)
+ * \brief This file defines the \ref pc::thread_pool class, a work stealing
+ * thread pool executing delegate<void()> tasks.
+ * \version 0.1
+ * \date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef PC_THREAD_POOL_HPP
+#define PC_THREAD_POOL_HPP
+#include "delegate.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pc {
+  /**
+   * \brief \anchor thread-pool-brief a work stealing thread pool. Tasks are
+   * delegate<void()> instances, i.e. they do not allocate as long as the bound
+   * callable fits into the delegate's storage.
+   *
+   * Each worker owns a task queue. Tasks submitted from a worker go to its own
+   * queue, tasks submitted from other threads are distributed round robin. A
+   * worker takes tasks from the back of its own queue and, once that is empty,
+   * steals from the front of the other workers' queues.
+   *
+   * Tasks should not throw. The exception of a task propagates out of
+   * try_run_one() if the calling thread runs it, and terminates the program
+   * if a worker thread runs it, like that of a std::thread. Either way, the
+   * task counts as finished. Callers which need the exception, like
+   * multicast_delegate::parallel_invoke(), catch it inside the task.
+   *
+   * The thread_pool is an executor in the sense of
+   * multicast_delegate::parallel_invoke(), i.e. it provides submit(),
+   * try_run_one() and num_workers().
+   */
+  class thread_pool {
+  public:
+    /// task type.
+    using task_t = delegate<void()>;
+
+    /**
+     * \brief construct and start the worker threads.
+     * \param num_threads number of worker threads. Defaults to the number of
+     * hardware threads.
+     */
+    explicit thread_pool(size_t num_threads = default_num_threads());
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    /// destructor. Runs all submitted tasks and joins the worker threads.
+    ~thread_pool();
+
+    /**
+     * \brief submit a task for execution on one of the worker threads.
+     * \param task task to execute, see the class description for exceptions.
+     */
+    void submit(task_t task);
+
+    /**
+     * \brief run one pending task on the calling thread. Threads waiting for
+     * tasks to finish should call this instead of blocking, so that waiting
+     * inside a task cannot dead lock the pool.
+     * \return true a task was run
+     * \return false no task was pending
+     */
+    bool try_run_one();
+
+    /// get the number of worker threads.
+    size_t num_workers() const;
+
+    /// number of hardware threads, at least 1.
+    static size_t default_num_threads();
+
+  private:
+    /// task queue of a single worker, on its own cache line.
+    struct alignas(impl::cache_line_size) worker_queue {
+      std::mutex         mutex;
+      std::deque<task_t> tasks;
+    };
+
+    /// main function of the worker threads.
+    void worker_loop(size_t index);
+    /// wake a sleeping worker, if there is one.
+    void notify_one();
+    /// take a task from the queue at index or steal one from another queue.
+    bool pop_or_steal(size_t index, task_t& task);
+    /// index of the calling thread's queue, or num_workers() if the calling
+    /// thread is not a worker of this pool.
+    size_t this_thread_index() const;
+
+    /// the pool and queue index of the worker thread executing this.
+    struct worker_id {
+      const thread_pool* pool{nullptr};
+      size_t             index{0};
+    };
+    static worker_id& this_worker();
+
+    std::vector<std::unique_ptr<worker_queue>> queues;
+    std::vector<std::thread>                   threads;
+    std::atomic<size_t>                        num_pending{0}; //< queued tasks
+    std::atomic<size_t>                        num_sleeping{0};
+    std::atomic<size_t>                        next_queue{0};
+    std::mutex                                 sleep_mutex;
+    std::condition_variable                    wake;
+    bool                                       stopping{false};
+  };
+
+  inline thread_pool::thread_pool(size_t num_threads) {
+    num_threads = num_threads == 0 ? 1 : num_threads;
+    for (size_t i = 0; i < num_threads; ++i)
+      queues.push_back(std::make_unique<worker_queue>());
+    for (size_t i = 0; i < num_threads; ++i)
+      threads.emplace_back([this, i] { worker_loop(i); });
+  }
+
+  inline thread_pool::~thread_pool() {
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex);
+      stopping = true;
+    }
+    wake.notify_all();
+    for (auto& t : threads)
+      t.join();
+  }
+
+  inline void thread_pool::submit(task_t task) {
+    size_t index = this_thread_index();
+    if (index == queues.size())
+      index = next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    num_pending.fetch_add(1, std::memory_order_seq_cst);
+    {
+      std::lock_guard<std::mutex> lock(queues[index]->mutex);
+      queues[index]->tasks.push_back(std::move(task));
+    }
+    notify_one();
+  }
+
+  inline bool thread_pool::try_run_one() {
+    size_t index = this_thread_index();
+    task_t task;
+    if (!pop_or_steal(index == queues.size() ? 0 : index, task))
+      return false;
+    task();
+    return true;
+  }
+
+  inline size_t thread_pool::num_workers() const { return threads.size(); }
+
+  inline size_t thread_pool::default_num_threads() {
+    const size_t n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+  }
+
+  inline void thread_pool::worker_loop(size_t index) {
+    this_worker() = worker_id{this, index};
+    task_t task;
+    while (true) {
+      if (pop_or_steal(index, task)) {
+        task();
+        task.reset();
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(sleep_mutex);
+      // announcing the sleep before checking num_pending pairs with submit()
+      // incrementing num_pending before checking num_sleeping. One of the two
+      // sees the other's increment.
+      num_sleeping.fetch_add(1, std::memory_order_seq_cst);
+      wake.wait(lock, [this] {
+        return stopping || num_pending.load(std::memory_order_seq_cst) != 0;
+      });
+      num_sleeping.fetch_sub(1, std::memory_order_relaxed);
+      if (stopping && num_pending.load(std::memory_order_acquire) == 0)
+        return;
+    }
+  }
+
+  inline void thread_pool::notify_one() {
+    if (num_sleeping.load(std::memory_order_seq_cst) == 0)
+      return;
+    // taking the mutex makes sure a worker which just found nothing to do is
+    // either already waiting or will see num_pending != 0.
+    { std::lock_guard<std::mutex> lock(sleep_mutex); }
+    wake.notify_one();
+  }
+
+  inline bool thread_pool::pop_or_steal(size_t index, task_t& task) {
+    {
+      // own queue: newest task first, it is the most likely to be cache hot.
+      std::lock_guard<std::mutex> lock(queues[index]->mutex);
+      if (!queues[index]->tasks.empty()) {
+        task = std::move(queues[index]->tasks.back());
+        queues[index]->tasks.pop_back();
+        num_pending.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+      }
+    }
+    for (size_t i = 1; i < queues.size(); ++i) {
+      // other queues: oldest task first.
+      worker_queue&               victim = *queues[(index + i) % queues.size()];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (!victim.tasks.empty()) {
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        num_pending.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  inline size_t thread_pool::this_thread_index() const {
+    const worker_id& id = this_worker();
+    return id.pool == this ? id.index : queues.size();
+  }
+
+  inline thread_pool::worker_id& thread_pool::this_worker() {
+    thread_local worker_id id;
+    return id;
+  }
+} // namespace pc
+
+#endif
@@ -0,0 +1,367 @@
+/**
+ * \file timer_wheel.hpp
+ * \author Pele Constam (pelectron1602\gmail.com)
+ * \brief This file defines the \ref pc::timer_wheel class, a hierarchical
+ * timer wheel which invokes delegates after a number of ticks.
+ * \version 0.1
+ * \date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef PC_TIMER_WHEEL_HPP
+#define PC_TIMER_WHEEL_HPP
+#include "delegate.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace pc {
+  namespace impl {
+    /// get the index of the lowest set bit of bits, which must not be 0.
+    inline unsigned lowest_bit(uint64_t bits) {
+#if defined(_MSC_VER) && !defined(__clang__)
+      unsigned long index;
+      _BitScanForward64(&index, bits);
+      return static_cast<unsigned>(index);
+#else
+      return static_cast<unsigned>(__builtin_ctzll(bits));
+#endif
+    }
+  } // namespace impl
+
+  /**
+   * \brief \anchor timer-wheel-brief a hashed hierarchical timer wheel. Timers
+   * are delegate<void()>s which are invoked once a number of ticks have
+   * passed. Scheduling and cancelling a timer is O(1), independent of the
+   * number of timers.
+   *
+   * The wheel has num_levels levels of slots_per_level slots each. A timer is
+   * put into the level of the highest slot_bits wide group of bits in which
+   * its expiry tick differs from the current tick, into the slot given by the
+   * expiry's bits of that group. Whenever the current tick crosses a boundary
+   * of a level, the timers of the level's current slot are moved down to
+   * lower levels, until they reach level 0, whose slot for the current tick
+   * holds the timers expiring now. Timers further in the future than the
+   * levels cover wait in an overflow list. A bitmap of the occupied slots per
+   * level lets advance() jump straight to the next tick on which a level is
+   * cascaded or timers expire, so idle ticks cost nothing.
+   *
+   * The timers are stored in place in a vector of nodes, which are reused
+   * through a free list, i.e. scheduling a timer only allocates when the
+   * vector grows or the callable does not fit into a delegate. The slots are
+   * intrusive doubly linked lists of nodes, linked by index. A timer_id
+   * contains the node index and a generation count, so cancelling a timer
+   * which has expired or was cancelled already does nothing.
+   *
+   * Expiry is batched: all timers of a slot are moved to a list of expiring
+   * timers at once, which are then invoked in turn. The callables may
+   * schedule and cancel timers, including the ones in the same batch.
+   *
+   * The wheel is not thread safe. It has no notion of time; the user calls
+   * advance() with the number of ticks passed.
+   */
+  class timer_wheel {
+  public:
+    /// tick count type.
+    using tick_t = uint64_t;
+    /// identifies a scheduled timer.
+    using timer_id = uint64_t;
+
+    /// never returned by schedule().
+    static constexpr timer_id invalid_timer = 0;
+    /// bits of a tick per level.
+    static constexpr unsigned slot_bits = 8;
+    /// number of slots per level.
+    static constexpr size_t slots_per_level = size_t{1} << slot_bits;
+    /// number of levels. Timers further than 2^(slot_bits * num_levels) ticks
+    /// in the future are put into the overflow list.
+    static constexpr unsigned num_levels = 4;
+
+    /**
+     * \brief construct a timer wheel.
+     * \param now the current tick
+     */
+    explicit timer_wheel(tick_t now = 0);
+
+    /**
+     * \brief schedule f to be invoked by advance() in delay ticks. A delay of
+     * 0 is treated as 1, i.e. f is not invoked before the next tick.
+     * \tparam F callable type, must be bindable to a delegate<void()>.
+     * \param delay number of ticks until f is invoked
+     * \param f callable
+     * \return timer_id identifies the timer for cancel()
+     */
+    template <typename F>
+    timer_id schedule(tick_t delay, F&& f);
+
+    /**
+     * \brief cancel a timer. Does nothing if the timer has expired or was
+     * cancelled already.
+     * \param id the timer
+     * \return true the timer was cancelled
+     * \return false the timer was not scheduled
+     */
+    bool cancel(timer_id id);
+
+    /**
+     * \brief advance the current tick and invoke the timers which expire on
+     * the way, in the order of their expiry.
+     * \param ticks number of ticks to advance
+     * \return size_t number of timers invoked
+     */
+    size_t advance(tick_t ticks);
+
+    /// get the current tick.
+    tick_t now() const { return current; }
+
+    /// get the number of scheduled timers.
+    size_t size() const { return num_timers; }
+
+    /// checks if no timers are scheduled.
+    bool empty() const { return num_timers == 0; }
+
+    /// reserve storage for n timers.
+    void reserve(size_t n) { nodes.reserve(num_sentinels + n); }
+
+  private:
+    /// a node of the intrusive lists. The first num_sentinels nodes are the
+    /// heads of the slot lists; they never hold a timer.
+    struct node {
+      delegate<void()> callback;
+      tick_t           expiry{0};
+      uint32_t         prev{npos}; //< npos if the node is free
+      uint32_t         next{npos}; //< next free node if the node is free
+      uint32_t         generation{1};
+    };
+
+    static constexpr uint32_t npos = ~uint32_t{0};
+    static constexpr uint32_t overflow_list = num_levels * slots_per_level;
+    static constexpr uint32_t expiring_list = overflow_list + 1;
+    static constexpr uint32_t num_sentinels = expiring_list + 1;
+    static constexpr size_t   words_per_level = slots_per_level / 64;
+
+    /// link node n into the list of the slot for its expiry.
+    void insert(uint32_t n);
+    /// link node n before the sentinel of list.
+    void link(uint32_t n, uint32_t list);
+    /// unlink node n from its list.
+    void unlink(uint32_t n);
+    /// reinsert all nodes of list.
+    void cascade(uint32_t list);
+    /// run the timers expiring at the current tick.
+    size_t expire();
+    /// get the next tick on which a level is cascaded or timers expire.
+    tick_t next_event() const;
+    /// get the first occupied slot of level at or after from, or
+    /// slots_per_level if there is none.
+    size_t next_occupied(unsigned level, size_t from) const;
+    /// get a free node.
+    uint32_t allocate_node();
+    /// give node n back to the free list.
+    void free_node(uint32_t n);
+
+    std::vector<node> nodes;
+    /// one bit per slot of the levels, set if the slot holds timers.
+    uint64_t          occupied[num_levels * words_per_level]{};
+    uint32_t          free_list{npos};
+    tick_t            current;
+    size_t            num_timers{0};
+  };
+
+  inline timer_wheel::timer_wheel(tick_t now)
+      : nodes(num_sentinels), current(now) {
+    for (uint32_t i = 0; i < num_sentinels; ++i) {
+      nodes[i].prev = i;
+      nodes[i].next = i;
+    }
+  }
+
+  template <typename F>
+  timer_wheel::timer_id timer_wheel::schedule(tick_t delay, F&& f) {
+    const uint32_t n = allocate_node();
+    node&          timer = nodes[n];
+    timer.callback.bind(std::forward<F>(f));
+    timer.expiry = current + (delay == 0 ? 1 : delay);
+    insert(n);
+    ++num_timers;
+    return (static_cast<timer_id>(timer.generation) << 32) | n;
+  }
+
+  inline bool timer_wheel::cancel(timer_id id) {
+    const auto n = static_cast<uint32_t>(id);
+    if (n < num_sentinels || n >= nodes.size() ||
+        nodes[n].generation != static_cast<uint32_t>(id >> 32) ||
+        nodes[n].prev == npos)
+      return false;
+    unlink(n);
+    free_node(n);
+    --num_timers;
+    return true;
+  }
+
+  inline size_t timer_wheel::advance(tick_t ticks) {
+    const tick_t target = current + ticks;
+    size_t       invoked = 0;
+    while (num_timers != 0) {
+      // jump over the ticks on which nothing happens.
+      const tick_t next = next_event();
+      if (next > target)
+        break;
+      current = next;
+      // move the timers of each level whose boundary was crossed down, from
+      // the highest level to the lowest.
+      if ((current & ((tick_t{1} << (slot_bits * num_levels)) - 1)) == 0)
+        cascade(overflow_list);
+      for (unsigned level = num_levels - 1; level > 0; --level) {
+        const unsigned shift = slot_bits * level;
+        if ((current & ((tick_t{1} << shift) - 1)) == 0)
+          cascade(static_cast<uint32_t>(
+              level * slots_per_level +
+              ((current >> shift) & (slots_per_level - 1))));
+      }
+      invoked += expire();
+    }
+    current = target;
+    return invoked;
+  }
+
+  inline timer_wheel::tick_t timer_wheel::next_event() const {
+    tick_t next = ~tick_t{0};
+    if (nodes[overflow_list].next != overflow_list) {
+      const unsigned shift = slot_bits * num_levels;
+      next = ((current >> shift) + 1) << shift;
+    }
+    for (unsigned level = 0; level < num_levels; ++level) {
+      // the occupied slots of a level are all after the current tick's slot.
+      const unsigned shift = slot_bits * level;
+      const size_t   slot = next_occupied(
+          level, ((current >> shift) & (slots_per_level - 1)) + 1);
+      if (slot == slots_per_level)
+        continue;
+      // the first tick of the current slot of the level above.
+      const unsigned above = shift + slot_bits;
+      const tick_t   first = current >> above << above;
+      next = std::min(next, first + (static_cast<tick_t>(slot) << shift));
+    }
+    return next;
+  }
+
+  inline size_t timer_wheel::next_occupied(unsigned level, size_t from) const {
+    for (size_t w = from / 64; w < words_per_level; ++w) {
+      uint64_t bits = occupied[level * words_per_level + w];
+      if (w == from / 64)
+        bits &= ~uint64_t{0} << (from % 64);
+      if (bits != 0)
+        return w * 64 + impl::lowest_bit(bits);
+    }
+    return slots_per_level;
+  }
+
+  inline void timer_wheel::insert(uint32_t n) {
+    const tick_t expiry = nodes[n].expiry;
+    const tick_t diff = expiry ^ current;
+    unsigned     level = 0;
+    while (level < num_levels && (diff >> (slot_bits * (level + 1))) != 0)
+      ++level;
+    if (level == num_levels) {
+      link(n, overflow_list);
+      return;
+    }
+    link(n, static_cast<uint32_t>(
+                level * slots_per_level +
+                ((expiry >> (slot_bits * level)) & (slots_per_level - 1))));
+  }
+
+  inline void timer_wheel::link(uint32_t n, uint32_t list) {
+    if (list < overflow_list)
+      occupied[list / 64] |= uint64_t{1} << (list % 64);
+    const uint32_t last = nodes[list].prev;
+    nodes[n].prev = last;
+    nodes[n].next = list;
+    nodes[last].next = n;
+    nodes[list].prev = n;
+  }
+
+  inline void timer_wheel::unlink(uint32_t n) {
+    const uint32_t prev = nodes[n].prev;
+    const uint32_t next = nodes[n].next;
+    nodes[prev].next = next;
+    nodes[next].prev = prev;
+    // only the sentinel is left if both neighbours are the same node.
+    if (prev == next && prev < overflow_list)
+      occupied[prev / 64] &= ~(uint64_t{1} << (prev % 64));
+  }
+
+  inline void timer_wheel::cascade(uint32_t list) {
+    uint32_t n = nodes[list].next;
+    nodes[list].prev = list;
+    nodes[list].next = list;
+    if (list < overflow_list)
+      occupied[list / 64] &= ~(uint64_t{1} << (list % 64));
+    while (n != list) {
+      const uint32_t next = nodes[n].next;
+      insert(n);
+      n = next;
+    }
+  }
+
+  inline size_t timer_wheel::expire() {
+    const auto slot = static_cast<uint32_t>(current & (slots_per_level - 1));
+    if (nodes[slot].next == slot)
+      return 0;
+    // splice the whole slot into the expiring list.
+    const uint32_t first = nodes[slot].next;
+    const uint32_t last = nodes[slot].prev;
+    nodes[first].prev = expiring_list;
+    nodes[last].next = expiring_list;
+    nodes[expiring_list].next = first;
+    nodes[expiring_list].prev = last;
+    nodes[slot].next = slot;
+    nodes[slot].prev = slot;
+    occupied[slot / 64] &= ~(uint64_t{1} << (slot % 64));
+
+    size_t invoked = 0;
+    while (nodes[expiring_list].next != expiring_list) {
+      const uint32_t n = nodes[expiring_list].next;
+      unlink(n);
+      // the callback may schedule timers, which can reallocate the nodes.
+      delegate<void()> callback = std::move(nodes[n].callback);
+      free_node(n);
+      --num_timers;
+      callback();
+      ++invoked;
+    }
+    return invoked;
+  }
+
+  inline uint32_t timer_wheel::allocate_node() {
+    if (free_list == npos) {
+      nodes.emplace_back();
+      return static_cast<uint32_t>(nodes.size() - 1);
+    }
+    const uint32_t n = free_list;
+    free_list = nodes[n].next;
+    return n;
+  }
+
+  inline void timer_wheel::free_node(uint32_t n) {
+    node& timer = nodes[n];
+    timer.callback.reset();
+    timer.prev = npos;
+    timer.next = free_list;
+    ++timer.generation;
+    free_list = n;
+  }
+} // namespace pc
+
+#endif
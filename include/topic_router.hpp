@@ -0,0 +1,418 @@
+/**
+ * \file topic_router.hpp
+ * \author Pele Constam (pelectron1602\gmail.com)
+ * \brief This file defines the \ref pc::topic_router<Ret(Args...)> class, which
+ * routes string topics to multicast_delegate channels subscribed with wildcard
+ * patterns.
+ * \version 0.1
+ * \date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef PC_TOPIC_ROUTER_HPP
+#define PC_TOPIC_ROUTER_HPP
+#include "multicast_delegate.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace pc {
+#ifndef GENERATING_DOCUMENTATION
+  /// forward declaration, intentionally left unimplemented.
+  template <typename>
+  class topic_router;
+#endif
+
+  namespace impl {
+    /// split a topic or pattern into its dot separated words.
+    inline std::vector<std::string_view> split_topic(std::string_view topic) {
+      std::vector<std::string_view> words;
+      size_t                        first = 0;
+      while (true) {
+        const size_t dot = topic.find('.', first);
+        if (dot == std::string_view::npos) {
+          words.push_back(topic.substr(first));
+          return words;
+        }
+        words.push_back(topic.substr(first, dot - first));
+        first = dot + 1;
+      }
+    }
+
+    /// checks if the words of topic, starting at t, match the words of
+    /// pattern, starting at p. '*' matches exactly one word, '#' zero or more.
+    inline bool topic_matches(const std::vector<std::string_view> &pattern,
+                              size_t                               p,
+                              const std::vector<std::string_view> &topic,
+                              size_t                               t) {
+      if (p == pattern.size())
+        return t == topic.size();
+      if (pattern[p] == "#") {
+        for (size_t i = t; i <= topic.size(); ++i) {
+          if (topic_matches(pattern, p + 1, topic, i))
+            return true;
+        }
+        return false;
+      }
+      if (t == topic.size())
+        return false;
+      return (pattern[p] == "*" || pattern[p] == topic[t]) &&
+             topic_matches(pattern, p + 1, topic, t + 1);
+    }
+
+    /// checks if topic matches pattern. See \ref pc::topic_router<Ret(Args...)>
+    /// for the pattern syntax.
+    inline bool topic_matches(std::string_view pattern, std::string_view topic) {
+      return topic_matches(split_topic(pattern), 0, split_topic(topic), 0);
+    }
+  } // namespace impl
+
+  /**
+   * \brief \anchor topic-router-brief routes string topics to
+   * multicast_delegate channels, one channel per subscribed pattern.
+   *
+   * Topics are words separated by dots, e.g. "orders.eu.created". Patterns
+   * have the same form, where the word '*' matches exactly one word and the
+   * word '#' matches zero or more words:
+   * \code{.cpp}
+   * pc::topic_router<void(int)> router;
+   * router.subscribe("orders.eu.*", [](int id) { ... });
+   * router.subscribe("orders.#", [](int id) { ... });
+   * router.publish("orders.eu.created", 42); // invokes both
+   * \endcode
+   *
+   * The patterns are stored in a trie with one word per edge. Each pattern's
+   * node holds the pattern's channel. Publishing to a topic for the first time
+   * walks the trie once to resolve the matching channels and caches the
+   * result per topic. Publishing to a topic again is a hash lookup, which does
+   * not copy the topic, followed by the invocation of the cached channels. The cache is kept up to date
+   * incrementally: only subscribing to a new pattern or unsubscribing the last
+   * callable of a pattern touches it, and then only the entries of topics the
+   * pattern matches. Since every topic ever published is cached, clear_cache()
+   * can be used to drop the entries of topics which are not published anymore.
+   *
+   * The bound callables may subscribe, unsubscribe and publish. A channel
+   * whose last callable is unsubscribed while publishing is removed once the
+   * outermost publish() returns, and channels of patterns subscribed while
+   * publishing are only invoked by later calls to publish().
+   *
+   * A topic_router is neither copyable nor movable.
+   *
+   * \tparam Ret return type of the channels
+   * \tparam Args argument types of the channels
+   */
+  template <typename Ret, typename... Args>
+  class topic_router<Ret(Args...)> {
+  public:
+    /// channel type.
+    using channel_t = multicast_delegate<Ret(Args...)>;
+    /// identifies a subscribed callable. Returned by subscribe().
+    using subscription_id = size_t;
+
+    /// default constructor, no patterns are subscribed.
+    topic_router() = default;
+    topic_router(const topic_router &) = delete;
+    topic_router &operator=(const topic_router &) = delete;
+
+    /**
+     * \brief bind a callable to the channel of pattern. Creates the channel if
+     * pattern has no callables yet.
+     * \param pattern topic pattern
+     * \param bind_args arguments to bind, see multicast_delegate::bind().
+     * \return the subscription id, see unsubscribe().
+     */
+    template <typename... BindArgs>
+    subscription_id subscribe(std::string_view pattern,
+                              BindArgs &&...bind_args);
+
+    /**
+     * \brief unbind a callable. Removes the channel of its pattern if it was
+     * the pattern's last callable.
+     * \param id id returned by subscribe()
+     * \return true the callable was unbound
+     * \return false no callable with this id is subscribed
+     */
+    bool unsubscribe(subscription_id id);
+
+    /**
+     * \brief invoke the channels of all patterns matching topic.
+     * \param topic topic, must not contain wildcards.
+     * \param args arguments
+     */
+    void publish(std::string_view topic, Args... args);
+
+    /**
+     * \brief get the channel of pattern. Use it to access the results or any
+     * other multicast_delegate functionality.
+     * \param pattern topic pattern
+     * \return channel_t* the channel, or nullptr if no callable is subscribed
+     * to pattern.
+     */
+    channel_t *channel(std::string_view pattern);
+
+    /// get the number of patterns with at least one subscribed callable.
+    size_t num_patterns() const;
+
+    /// get the number of cached topics.
+    size_t num_cached_topics() const;
+
+    /// drop all cached topics. They are resolved again when published.
+    void clear_cache();
+
+  private:
+    /// a node of the pattern trie. The path from the root to a node spells out
+    /// the node's pattern.
+    struct node {
+      std::map<std::string, std::unique_ptr<node>, std::less<>> children;
+      node                      *parent{nullptr};
+      std::string                word;    //< word of the edge from parent
+      std::string                pattern; //< set if channel is set
+      std::unique_ptr<channel_t> channel; //< set if the pattern is subscribed
+      size_t                     num_subscribers{0};
+    };
+
+    /// a subscribed callable.
+    struct subscription {
+      node                               *leaf;
+      typename channel_t::subscription_id channel_id;
+    };
+
+    /// marks the router as publishing for its lifetime. The outermost guard
+    /// removes the channels emptied while publishing.
+    struct publish_guard {
+      explicit publish_guard(topic_router &r) : self(r) { ++self.publish_depth; }
+      ~publish_guard() {
+        if (--self.publish_depth == 0)
+          self.apply_pending();
+      }
+      topic_router &self;
+    };
+
+    /// get the node of pattern, or nullptr if it is not in the trie.
+    node *find_node(std::string_view pattern);
+    /// get the node of pattern. Creates it if it is not in the trie.
+    node *make_node(std::string_view pattern);
+    /// collect the channels of the patterns below n matching topic[t...].
+    void resolve(node *n, const std::vector<std::string_view> &topic, size_t t,
+                 std::vector<channel_t *> &channels);
+    /// remove the channel of leaf and the nodes which become unused.
+    void prune(node *leaf);
+    /// prune the channels emptied while publishing.
+    void apply_pending();
+    /// drop the cache and the topics its keys view into.
+    void clear_topics();
+
+    node root;
+    /// the cached topics. The keys of cache view into them, which lets
+    /// publish() look topics up without building a std::string. A deque never
+    /// moves its elements when growing.
+    std::deque<std::string>                                        topics;
+    std::unordered_map<std::string_view, std::vector<channel_t *>> cache;
+    std::unordered_map<subscription_id, subscription> subscriptions;
+    std::vector<node *> pending_prune; //< emptied while publishing
+    size_t              num_leaves{0};
+    size_t              publish_depth{0};
+    subscription_id     next_id{0};
+    bool                clear_pending{false};
+  };
+
+  template <typename Ret, typename... Args>
+  template <typename... BindArgs>
+  typename topic_router<Ret(Args...)>::subscription_id
+      topic_router<Ret(Args...)>::subscribe(std::string_view pattern,
+                                            BindArgs &&...bind_args) {
+    node *leaf = make_node(pattern);
+    if (!leaf->channel) {
+      leaf->channel = std::make_unique<channel_t>();
+      leaf->pattern = std::string(pattern);
+      ++num_leaves;
+      // a new channel only affects the cached topics it matches.
+      const auto words = impl::split_topic(pattern);
+      for (auto &[topic, channels] : cache) {
+        if (impl::topic_matches(words, 0, impl::split_topic(topic), 0))
+          channels.push_back(leaf->channel.get());
+      }
+    }
+    ++leaf->num_subscribers;
+    const subscription_id id = next_id++;
+    subscriptions.emplace(
+        id, subscription{leaf, leaf->channel->bind(
+                                   std::forward<BindArgs>(bind_args)...)});
+    return id;
+  }
+
+  template <typename Ret, typename... Args>
+  bool topic_router<Ret(Args...)>::unsubscribe(subscription_id id) {
+    const auto it = subscriptions.find(id);
+    if (it == subscriptions.end())
+      return false;
+    node *leaf = it->second.leaf;
+    leaf->channel->unbind(it->second.channel_id);
+    subscriptions.erase(it);
+    if (--leaf->num_subscribers == 0) {
+      // the channel may be the one being invoked, so it is kept alive until
+      // the outermost publish() returns.
+      if (publish_depth != 0)
+        pending_prune.push_back(leaf);
+      else
+        prune(leaf);
+    }
+    return true;
+  }
+
+  template <typename Ret, typename... Args>
+  void topic_router<Ret(Args...)>::publish(std::string_view topic,
+                                           Args... args) {
+    publish_guard guard(*this);
+    auto          it = cache.find(topic);
+    if (it == cache.end()) {
+      std::vector<channel_t *> channels;
+      resolve(&root, impl::split_topic(topic), 0, channels);
+      topics.emplace_back(topic);
+      it = cache.emplace(topics.back(), std::move(channels)).first;
+    }
+    // channels subscribed by the callables are appended to the cache entry,
+    // which may reallocate. Index into it and stop at the channels it had
+    // when publishing started.
+    auto        &channels = it->second;
+    const size_t n = channels.size();
+    for (size_t i = 0; i < n; ++i)
+      (*channels[i])(args...);
+  }
+
+  template <typename Ret, typename... Args>
+  typename topic_router<Ret(Args...)>::channel_t *
+      topic_router<Ret(Args...)>::channel(std::string_view pattern) {
+    node *n = find_node(pattern);
+    return n != nullptr && n->num_subscribers != 0 ? n->channel.get() : nullptr;
+  }
+
+  template <typename Ret, typename... Args>
+  size_t topic_router<Ret(Args...)>::num_patterns() const {
+    return num_leaves;
+  }
+
+  template <typename Ret, typename... Args>
+  size_t topic_router<Ret(Args...)>::num_cached_topics() const {
+    return cache.size();
+  }
+
+  template <typename Ret, typename... Args>
+  void topic_router<Ret(Args...)>::clear_cache() {
+    // publish() holds a reference into the cache.
+    if (publish_depth != 0)
+      clear_pending = true;
+    else
+      clear_topics();
+  }
+
+  template <typename Ret, typename... Args>
+  void topic_router<Ret(Args...)>::clear_topics() {
+    cache.clear();
+    topics.clear();
+  }
+
+  template <typename Ret, typename... Args>
+  typename topic_router<Ret(Args...)>::node *
+      topic_router<Ret(Args...)>::find_node(std::string_view pattern) {
+    node *n = &root;
+    for (const auto word : impl::split_topic(pattern)) {
+      const auto it = n->children.find(word);
+      if (it == n->children.end())
+        return nullptr;
+      n = it->second.get();
+    }
+    return n;
+  }
+
+  template <typename Ret, typename... Args>
+  typename topic_router<Ret(Args...)>::node *
+      topic_router<Ret(Args...)>::make_node(std::string_view pattern) {
+    node *n = &root;
+    for (const auto word : impl::split_topic(pattern)) {
+      auto it = n->children.find(word);
+      if (it == n->children.end()) {
+        auto child = std::make_unique<node>();
+        child->parent = n;
+        child->word = std::string(word);
+        it = n->children.emplace(child->word, std::move(child)).first;
+      }
+      n = it->second.get();
+    }
+    return n;
+  }
+
+  template <typename Ret, typename... Args>
+  void topic_router<Ret(Args...)>::resolve(
+      node *n, const std::vector<std::string_view> &topic, size_t t,
+      std::vector<channel_t *> &channels) {
+    if (const auto hash = n->children.find("#"); hash != n->children.end()) {
+      for (size_t i = t; i <= topic.size(); ++i)
+        resolve(hash->second.get(), topic, i, channels);
+    }
+    if (t == topic.size()) {
+      // patterns with several '#' can match the same topic in more than one
+      // way, but their channel must only be invoked once.
+      if (n->channel && std::find(channels.begin(), channels.end(),
+                                  n->channel.get()) == channels.end())
+        channels.push_back(n->channel.get());
+      return;
+    }
+    if (const auto it = n->children.find(topic[t]); it != n->children.end())
+      resolve(it->second.get(), topic, t + 1, channels);
+    if (const auto star = n->children.find("*"); star != n->children.end())
+      resolve(star->second.get(), topic, t + 1, channels);
+  }
+
+  template <typename Ret, typename... Args>
+  void topic_router<Ret(Args...)>::prune(node *leaf) {
+    channel_t *ch = leaf->channel.get();
+    const auto words = impl::split_topic(leaf->pattern);
+    for (auto &[topic, channels] : cache) {
+      if (impl::topic_matches(words, 0, impl::split_topic(topic), 0))
+        channels.erase(std::remove(channels.begin(), channels.end(), ch),
+                       channels.end());
+    }
+    leaf->channel.reset();
+    leaf->pattern.clear();
+    --num_leaves;
+    node *n = leaf;
+    while (n != &root && n->children.empty() && !n->channel) {
+      node *parent = n->parent;
+      parent->children.erase(n->word);
+      n = parent;
+    }
+  }
+
+  template <typename Ret, typename... Args>
+  void topic_router<Ret(Args...)>::apply_pending() {
+    if (clear_pending) {
+      clear_topics();
+      clear_pending = false;
+    }
+    // a leaf may have been subscribed to again, or be listed twice if it was
+    // emptied twice while publishing. The duplicate check comes first, since
+    // the first entry may have freed the leaf.
+    std::vector<node *> leaves = std::move(pending_prune);
+    pending_prune.clear();
+    for (size_t i = 0; i < leaves.size(); ++i) {
+      if (std::find(leaves.begin(), leaves.begin() + i, leaves[i]) ==
+              leaves.begin() + i &&
+          leaves[i]->num_subscribers == 0)
+        prune(leaves[i]);
+    }
+  }
+} // namespace pc
+
+#endif
@@ -0,0 +1,114 @@
+/**
+ * @file atomic_delegate.t.cpp
+ * @author Pele Constam (pelectron1602@gmail.com)
+ * @brief This file contains the tests for the atomic_delegate, qsbr_domain and
+ * qsbr_reader classes.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "atomic_delegate.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace pc;
+
+#include "catch2/catch.hpp"
+
+/// counts its live instances.
+struct counted {
+  static inline std::atomic<int> alive{0};
+  explicit counted(int v) : value(v) { alive.fetch_add(1); }
+  counted(const counted& other) : value(other.value) { alive.fetch_add(1); }
+  ~counted() { alive.fetch_sub(1); }
+  int operator()(int x) const { return x + value; }
+  int value;
+};
+
+SCENARIO("testing atomic_delegate") {
+  GIVEN("an atomic_delegate with its own domain") {
+    qsbr_domain               domain;
+    atomic_delegate<int(int)> d(domain);
+    REQUIRE_FALSE(d.is_valid());
+    WHEN("binding a callable") {
+      d.bind([](int x) { return 2 * x; });
+      THEN("invoking it calls the callable") {
+        REQUIRE(d.is_valid());
+        REQUIRE(d(21) == 42);
+      }
+      AND_WHEN("rebinding it without registered readers") {
+        d.bind(counted(5));
+        THEN("the old callable is deleted right away") {
+          REQUIRE(domain.num_retired() == 0);
+          REQUIRE(d(1) == 6);
+        }
+      }
+    }
+    WHEN("a registered reader has not passed a quiescent state") {
+      {
+        qsbr_reader reader(domain);
+        d.bind(counted(1));
+        d.bind(counted(2));
+        THEN("the replaced callables are kept") {
+          REQUIRE(domain.num_retired() == 2);
+          REQUIRE(counted::alive.load() == 2);
+          reader.quiescent();
+          REQUIRE(domain.reclaim() == 2);
+          REQUIRE(counted::alive.load() == 1);
+        }
+        THEN("going offline releases them too") {
+          reader.offline();
+          REQUIRE(domain.reclaim() == 2);
+          reader.online();
+          d.bind(counted(3));
+          REQUIRE(domain.num_retired() == 1);
+        }
+      }
+      domain.reclaim();
+    }
+    WHEN("resetting it") {
+      d.bind([](int x) { return x; });
+      d.reset();
+      THEN("no callable is bound") { REQUIRE_FALSE(d.is_valid()); }
+    }
+  }
+  GIVEN("reader threads invoking while a writer rebinds") {
+    qsbr_domain               domain;
+    atomic_delegate<int(int)> d(domain);
+    d.bind(counted(0));
+    std::atomic<bool>        done{false};
+    std::atomic<int>         bad{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; ++t) {
+      readers.emplace_back([&] {
+        qsbr_reader reader(domain);
+        while (!done.load()) {
+          for (int i = 0; i < 100; ++i) {
+            // every bound callable adds a value in [0, 1000).
+            const int v = d(1000);
+            if (v < 1000 || v >= 2000)
+              bad.fetch_add(1);
+          }
+          reader.quiescent();
+        }
+      });
+    }
+    for (int i = 1; i < 1000; ++i)
+      d.bind(counted(i));
+    done.store(true);
+    for (auto& t : readers)
+      t.join();
+    domain.reclaim();
+    THEN("readers only see valid callables and all old ones are deleted") {
+      REQUIRE(bad.load() == 0);
+      REQUIRE(domain.num_retired() == 0);
+      REQUIRE(counted::alive.load() == 1);
+    }
+  }
+}
@@ -0,0 +1,114 @@
+/**
+ * @file call_queue.t.cpp
+ * @author Pele Constam (pelectron1602@gmail.com)
+ * @brief This file contains the tests for the spsc_call_queue and
+ * mpsc_call_queue classes.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "call_queue.hpp"
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace pc;
+
+namespace {
+  /// counts its live instances.
+  struct Counted {
+    explicit Counted(int& count) : count(&count) { ++*this->count; }
+    Counted(const Counted& other) : count(other.count) { ++*count; }
+    ~Counted() { --*count; }
+    int* count;
+  };
+} // namespace
+
+#include "catch2/catch.hpp"
+SCENARIO("testing spsc_call_queue") {
+  GIVEN("an spsc_call_queue with 4 slots") {
+    spsc_call_queue queue(3);
+    REQUIRE(queue.capacity() == 4);
+    REQUIRE(queue.empty());
+    std::vector<std::string> log;
+    WHEN("pushing a delegate and a lambda with big captures") {
+      delegate<void(const char*, int)> del([&log](const char* s, int i) {
+        log.push_back(s + std::to_string(i));
+      });
+      REQUIRE(queue.try_push(del, "del", 1));
+      const double a = 1, b = 2, c = 3;
+      REQUIRE(queue.try_push([&log, a, b, c] {
+        log.push_back(std::to_string(static_cast<int>(a + b + c)));
+      }));
+      THEN("the calls are run in order") {
+        REQUIRE_FALSE(queue.empty());
+        REQUIRE(queue.try_run_one());
+        REQUIRE(queue.try_run_one());
+        REQUIRE_FALSE(queue.try_run_one());
+        REQUIRE(log == std::vector<std::string>{"del1", "6"});
+      }
+    }
+    WHEN("filling the queue") {
+      for (int i = 0; i < 4; ++i) {
+        REQUIRE(
+            queue.try_push([&log, i] { log.push_back(std::to_string(i)); }));
+      }
+      THEN("pushing fails until a call is run") {
+        REQUIRE_FALSE(queue.try_push([] {}));
+        REQUIRE(queue.drain(1) == 1);
+        REQUIRE(queue.try_push([&log] { log.push_back("4"); }));
+        REQUIRE(queue.drain() == 4);
+        REQUIRE(log == std::vector<std::string>{"0", "1", "2", "3", "4"});
+      }
+    }
+    WHEN("destroying a queue with pending calls") {
+      int count = 0;
+      {
+        spsc_call_queue pending(4);
+        REQUIRE(pending.try_push([](const Counted&) {}, Counted(count)));
+        REQUIRE(
+            pending.try_push([](const Counted&) { FAIL(); }, Counted(count)));
+        REQUIRE(count == 2);
+        REQUIRE(pending.try_run_one());
+        REQUIRE(count == 1);
+      }
+      THEN("the calls are destroyed without running them") {
+        REQUIRE(count == 0);
+      }
+    }
+  }
+}
+
+SCENARIO("testing mpsc_call_queue") {
+  GIVEN("an mpsc_call_queue and four producer threads") {
+    mpsc_call_queue          queue(64);
+    constexpr int            per_producer = 10000;
+    long                     sum = 0;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < 4; ++p) {
+      producers.emplace_back([&queue, &sum] {
+        for (int i = 1; i <= per_producer; ++i) {
+          while (!queue.try_push([&sum](int a) { sum += a; }, i))
+            std::this_thread::yield();
+        }
+      });
+    }
+    WHEN("draining on the consumer thread") {
+      int run = 0;
+      while (run < 4 * per_producer)
+        run += static_cast<int>(queue.drain(16));
+      for (auto& t : producers)
+        t.join();
+      THEN("every call is run exactly once") {
+        REQUIRE(queue.empty());
+        REQUIRE(sum == 4L * per_producer * (per_producer + 1) / 2);
+      }
+    }
+  }
+}
@@ -0,0 +1,104 @@
+/**
+ * @file compose.t.cpp
+ * @author Pele Constam (pelectron1602@gmail.com)
+ * @brief This file contains the tests for pipeline, compose() and the
+ * then(), map() and filter() members of delegate.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "compose.hpp"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace pc;
+
+#include "catch2/catch.hpp"
+
+static int times_two(int x) { return 2 * x; }
+
+SCENARIO("testing delegate composition") {
+  GIVEN("two delegates") {
+    delegate<int(int)> first(&times_two);
+    delegate<int(int)> second([](int x) { return x + 1; });
+    WHEN("composing them with then") {
+      auto composed = first.then(std::ref(second));
+      THEN("the composition references both and fits inline") {
+        REQUIRE(sizeof(composed) <= impl::max_storage_size);
+        delegate<int(int)> d(composed);
+        REQUIRE(d(5) == 11);
+        second.bind([](int x) { return x - 1; });
+        REQUIRE(d(5) == 9);
+      }
+    }
+    WHEN("mapping and filtering the result") {
+      delegate<std::string(int)> d(
+          first.filter([](int x) { return x > 10; }).map([](int x) {
+            return std::to_string(x);
+          }));
+      THEN("rejected results are value initialized") {
+        REQUIRE(d(6) == "12");
+        REQUIRE(d(5).empty());
+      }
+    }
+  }
+  GIVEN("delegates returning void") {
+    std::vector<int>    calls;
+    delegate<void(int)> first([&calls](int x) { calls.push_back(x); });
+    WHEN("composing them with then") {
+      delegate<void(int)> d(first.then([&calls](int x) {
+        calls.push_back(10 * x);
+      }));
+      d(3);
+      THEN("each stage gets the arguments") {
+        REQUIRE(calls == std::vector<int>{3, 30});
+      }
+    }
+    WHEN("filtering values before a delegate") {
+      delegate<void(int)> d(compose([](int x) { return x + 1; })
+                                .filter([](int x) { return x % 2 == 0; })
+                                .then(std::ref(first)));
+      d(3);
+      d(4);
+      THEN("it only gets the accepted values") {
+        REQUIRE(calls == std::vector<int>{4});
+      }
+    }
+    WHEN("filtering after a delegate returning void") {
+      delegate<void(int)> d(first.filter([](int x) { return x > 0; }));
+      d(-1);
+      d(1);
+      THEN("the predicate sees the arguments, the delegate runs first") {
+        REQUIRE(calls == std::vector<int>{-1, 1});
+      }
+    }
+  }
+  GIVEN("a pipeline of stages without state") {
+    auto p = compose([](int a, int b) { return a + b; })
+                 .map([](int x) { return x * x; })
+                 .filter([](int x) { return x < 100; })
+                 .then([](int x) { return x + 0.5; });
+    THEN("it takes no space and calls the stages in sequence") {
+      REQUIRE(sizeof(p) == 1);
+      REQUIRE(p(2, 3) == 25.5);
+      REQUIRE(p(5, 5) == 0.0);
+      delegate<double(int, int)> d(p);
+      REQUIRE(d(1, 2) == 9.5);
+    }
+  }
+  GIVEN("a stage with state") {
+    int  offset = 7;
+    auto p = compose([offset](int x) { return x + offset; });
+    auto q = p.then([](int x) { return -x; });
+    THEN("extending a pipeline copies it") {
+      REQUIRE(p(1) == 8);
+      REQUIRE(q(1) == -8);
+    }
+  }
+}
@@ -0,0 +1,94 @@
+/**
+ * @file concurrent_multicast_delegate.t.cpp
+ * @author Pele Constam (pelectron1602@gmail.com)
+ * @brief This file contains the tests for the concurrent_multicast_delegate
+ * class.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "concurrent_multicast_delegate.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace pc;
+
+namespace {
+  int square(int a) { return a * a; }
+} // namespace
+
+#include "catch2/catch.hpp"
+SCENARIO("testing concurrent_multicast_delegate") {
+  GIVEN("a default constructed concurrent_multicast_delegate") {
+    concurrent_multicast_delegate<int(int)> del;
+    REQUIRE(del.num_callables() == 0);
+    WHEN("callables are bound and unbound") {
+      auto id1 = del.bind(&square);
+      auto id2 = del.bind([](int a) { return a + 1; });
+      del.bind([](int a) { return a - 1; });
+      REQUIRE(del.num_callables() == 3);
+      REQUIRE(del.unbind(id2));
+      REQUIRE_FALSE(del.unbind(id2));
+      THEN("the remaining callables are invoked in bind order") {
+        std::vector<int> results;
+        del.invoke_into(std::back_inserter(results), 3);
+        REQUIRE(results == std::vector<int>{9, 2});
+      }
+      AND_WHEN("resetting it") {
+        del.reset();
+        THEN("no callables are bound") {
+          REQUIRE(del.num_callables() == 0);
+          REQUIRE_FALSE(del.unbind(id1));
+        }
+      }
+    }
+  }
+  GIVEN("threads invoking while another thread binds and unbinds") {
+    concurrent_multicast_delegate<void(int)> del;
+    std::atomic<long>                        base_calls{0};
+    std::atomic<long>                        churn_calls{0};
+    del.bind([&base_calls](int) { base_calls.fetch_add(1); });
+    static constexpr int     num_threads = 4;
+    static constexpr int     num_emits = 2000;
+    std::atomic<int>         finished{0};
+    std::vector<std::thread> emitters;
+    for (int i = 0; i < num_threads; ++i) {
+      emitters.emplace_back([&] {
+        for (int n = 0; n < num_emits; ++n)
+          del(1);
+        finished.fetch_add(1);
+      });
+    }
+    while (finished.load() != num_threads) {
+      auto id = del.bind([&churn_calls](int) { churn_calls.fetch_add(1); });
+      del.unbind(id);
+    }
+    for (auto& t : emitters)
+      t.join();
+    THEN("every invocation reached the bound callable") {
+      REQUIRE(del.num_callables() == 1);
+      REQUIRE(base_calls.load() == num_threads * num_emits);
+      REQUIRE(churn_calls.load() <= num_threads * num_emits);
+    }
+  }
+#ifndef PC_DELEGATE_NO_EXCEPTIONS
+  GIVEN("a concurrent_multicast_delegate with a callable which throws") {
+    concurrent_multicast_delegate<int(int)> del;
+    del.bind([](int a) -> int { throw a; });
+    WHEN("invoking it") {
+      REQUIRE_THROWS_AS(del(1), int);
+      THEN("the invocation has ended and callables can still be bound") {
+        del.reset();
+        del.bind(&square);
+        REQUIRE(del.num_callables() == 1);
+      }
+    }
+  }
+#endif
+}
@@ -0,0 +1,230 @@
+/**
+ * @file coroutine.t.cpp
+ * @author Pele Constam (pelectron1602@gmail.com)
+ * @brief This file contains the tests for pc::task, delegates returning tasks
+ * and multicast_delegate::emit_async(). Only built if the compiler supports
+ * coroutines.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "coroutine.hpp"
+#include "multicast_delegate.hpp"
+#include "thread_pool.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace pc;
+
+#include "catch2/catch.hpp"
+
+/// a fire and forget coroutine, used to await tasks from the test cases.
+struct detached {
+  struct promise_type {
+    detached            get_return_object() { return {}; }
+    std::suspend_never  initial_suspend() noexcept { return {}; }
+    std::suspend_never  final_suspend() noexcept { return {}; }
+    void                return_void() {}
+    void                unhandled_exception() { std::terminate(); }
+  };
+};
+
+template <typename Awaitable, typename Result>
+detached await_into(Awaitable a, Result& result, std::atomic<bool>& done) {
+  result = co_await std::move(a);
+  done.store(true);
+}
+
+template <typename Awaitable>
+detached await_void(Awaitable a, std::atomic<bool>& done) {
+  co_await std::move(a);
+  done.store(true);
+}
+
+/// resumes the awaiting coroutine on one of the pool's threads.
+struct resume_on {
+  thread_pool& pool;
+  bool         await_ready() { return false; }
+  void         await_suspend(std::coroutine_handle<> h) {
+    pool.submit([h] { h.resume(); });
+  }
+  void await_resume() {}
+};
+
+/// suspends the awaiting coroutine and hands it out, to be resumed by hand.
+struct park {
+  std::vector<std::coroutine_handle<>>& parked;
+  bool                                  await_ready() { return false; }
+  void await_suspend(std::coroutine_handle<> h) { parked.push_back(h); }
+  void await_resume() {}
+};
+
+/// awaits a chain of depth nested when_all() calls. Every level parks before
+/// it starts the next one, so the chain is built without nesting.
+task<int> nested(int depth, std::vector<std::coroutine_handle<>>& parked) {
+  co_await park{parked};
+  if (depth == 0)
+    co_return 0;
+  std::vector<task<int>> children;
+  children.push_back(nested(depth - 1, parked));
+  std::vector<int> values = co_await when_all(std::move(children));
+  co_return values[0] + 1;
+}
+
+/// counts allocations and forwards them to a frame_pool.
+struct counting_pool {
+  void* allocate(size_t size) {
+    ++allocations;
+    return pool.allocate(size);
+  }
+  void deallocate(void* p, size_t size) {
+    ++deallocations;
+    pool.deallocate(p, size);
+  }
+  frame_pool pool;
+  int        allocations{0};
+  int        deallocations{0};
+};
+
+SCENARIO("testing delegates returning tasks") {
+  GIVEN("a delegate bound to a coroutine lambda") {
+    delegate<task<int>(int)> twice([](int v) -> task<int> { co_return 2 * v; });
+    WHEN("awaiting the returned task") {
+      int               result = 0;
+      std::atomic<bool> done{false};
+      await_into(twice(21), result, done);
+      THEN("the value is returned") {
+        REQUIRE(done.load());
+        REQUIRE(result == 42);
+      }
+    }
+    WHEN("a task awaits another task") {
+      delegate<task<int>(int)> quad([&twice](int v) -> task<int> {
+        const int a = co_await twice(v);
+        co_return a + co_await twice(v);
+      });
+      int               result = 0;
+      std::atomic<bool> done{false};
+      await_into(quad(3), result, done);
+      THEN("the values are combined") {
+        REQUIRE(done.load());
+        REQUIRE(result == 12);
+      }
+    }
+  }
+  GIVEN("an empty delegate returning a task") {
+    delegate<task<int>()> empty;
+    int                   result = 1;
+    std::atomic<bool>     done{false};
+    await_into(empty(), result, done);
+    THEN("awaiting the invalid task results in a value initialized value") {
+      REQUIRE(done.load());
+      REQUIRE(result == 0);
+    }
+  }
+  GIVEN("a task which throws") {
+    auto thrower = []() -> task<int> {
+      throw std::runtime_error("error");
+      co_return 0;
+    };
+    THEN("awaiting it rethrows the exception") {
+      std::vector<task<int>> tasks;
+      tasks.push_back(thrower());
+      auto group = when_all(std::move(tasks));
+      REQUIRE_FALSE(group.await_ready());
+      REQUIRE_FALSE(group.await_suspend(std::noop_coroutine()));
+      REQUIRE_THROWS_AS(group.await_resume(), std::runtime_error);
+    }
+  }
+  GIVEN("a frame_pool_scope") {
+    counting_pool pool;
+    {
+      frame_pool_scope scope(pool);
+      for (int i = 0; i < 10; ++i) {
+        auto t = [](int v) -> task<int> { co_return v; }(i);
+        int               result = 0;
+        std::atomic<bool> done{false};
+        await_into(std::move(t), result, done);
+        REQUIRE(result == i);
+      }
+    }
+    THEN("the frames were allocated from the pool") {
+      // the detached coroutines are not tasks and use operator new.
+      REQUIRE(pool.allocations == 10);
+      REQUIRE(pool.deallocations == 10);
+    }
+  }
+}
+
+SCENARIO("testing multicast_delegate::emit_async") {
+  GIVEN("a multicast_delegate with coroutine subscribers") {
+    multicast_delegate<task<int>(const std::string&)> md;
+    for (int i = 0; i < 4; ++i) {
+      md.bind([i](const std::string& s) -> task<int> {
+        co_return static_cast<int>(s.size()) + i;
+      });
+    }
+    WHEN("emitting") {
+      std::vector<int>  result;
+      std::atomic<bool> done{false};
+      await_into(md.emit_async(std::string("abc")), result, done);
+      THEN("the values are in the order of the subscribers") {
+        REQUIRE(done.load());
+        REQUIRE(result == std::vector<int>{3, 4, 5, 6});
+      }
+    }
+  }
+  GIVEN("subscribers which resume on other threads") {
+    thread_pool                               pool(2);
+    std::atomic<int>                          sum{0};
+    multicast_delegate<task<void>(int, int)> md;
+    for (int i = 0; i < 8; ++i) {
+      md.bind([&pool, &sum](int a, int b) -> task<void> {
+        co_await resume_on{pool};
+        sum.fetch_add(a + b);
+      });
+    }
+    WHEN("emitting") {
+      std::atomic<bool> done{false};
+      await_void(md.emit_async(1, 2), done);
+      THEN("the awaiting coroutine resumes once all subscribers are done") {
+        while (!done.load()) {
+          if (!pool.try_run_one())
+            std::this_thread::yield();
+        }
+        REQUIRE(sum.load() == 24);
+      }
+    }
+  }
+  GIVEN("a deep chain of when_all() calls which finishes asynchronously") {
+    std::vector<std::coroutine_handle<>> parked;
+    int                                  result = 0;
+    std::atomic<bool>                    done{false};
+    await_into(nested(100000, parked), result, done);
+    WHEN("resuming the levels until the innermost one finishes") {
+      while (!parked.empty()) {
+        auto h = parked.back();
+        parked.pop_back();
+        h.resume();
+      }
+      THEN("the waiters are resumed without growing the stack") {
+        REQUIRE(done.load());
+        REQUIRE(result == 100000);
+      }
+    }
+  }
+  GIVEN("a multicast_delegate without subscribers") {
+    multicast_delegate<task<void>()> md;
+    std::atomic<bool>                done{false};
+    await_void(md.emit_async(), done);
+    THEN("awaiting completes right away") { REQUIRE(done.load()); }
+  }
+}
@@ -19,7 +19,10 @@
  */
 #include "delegate.hpp"
 
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <vector>
 
 using namespace pc;
 
@@ -344,3 +347,367 @@ TEMPLATE_TEST_CASE("delegate reset", "[delegate reset] [template]", int, float,
   }
 }
 
+
+SCENARIO("delegate argument passing") {
+  GIVEN("a delegate taking a non trivially copyable argument by value") {
+    delegate<bool(Small_t<int>)> delegate(
+        [](const Small_t<int> &s) { return s.copied; });
+    WHEN("invoking it with an lvalue") {
+      Small_t<int> arg;
+      bool         copied = delegate(arg);
+      THEN("the callable receives the caller's object") {
+        REQUIRE_FALSE(copied);
+      }
+    }
+  }
+}
+
+int twice(int a) { return 2 * a; }
+
+SCENARIO("delegate guarded invocation") {
+  GIVEN("a delegate bound to a free function") {
+    delegate<int(int)> delegate(&free_f_t<int>);
+    inline_cache_stats stats;
+    THEN("expecting that function hits") {
+      REQUIRE(delegate.expect<&free_f_t<int>>());
+      REQUIRE(delegate.invoke_expecting<&free_f_t<int>>(stats, 5) == 5);
+      REQUIRE(stats.hits == 1);
+      REQUIRE(stats.misses == 0);
+    }
+    WHEN("expecting another function with the same signature") {
+      int result = delegate.invoke_expecting<&twice>(stats, 5);
+      THEN("the call misses and the bound function is invoked") {
+        REQUIRE(result == 5);
+        REQUIRE(stats.misses == 1);
+        REQUIRE(stats.hit_rate() == 0.0);
+      }
+    }
+  }
+  GIVEN("a delegate bound to an object and member function") {
+    Small_t<int>       small;
+    delegate<int(int)> delegate(small, &Small_t<int>::member_func);
+    THEN("expecting that member function hits, other ones miss") {
+      REQUIRE(delegate.expect<&Small_t<int>::member_func>());
+      REQUIRE_FALSE(delegate.expect<&Small_t<int>::noexcept_member_func>());
+      REQUIRE_FALSE(delegate.expect<&Small_t<int>::const_member_func>());
+      REQUIRE(delegate.invoke_expecting<&Small_t<int>::member_func>(3) == 3);
+    }
+    WHEN("binding the const member function") {
+      delegate.bind(small, &Small_t<int>::const_member_func);
+      THEN("expecting it hits") {
+        REQUIRE(delegate.expect<&Small_t<int>::const_member_func>());
+        REQUIRE(delegate.invoke_expecting<&Small_t<int>::const_member_func>(
+                    4) == 4);
+      }
+    }
+  }
+  GIVEN("delegates bound to small and big function objects") {
+    delegate<int(int)> small_delegate{Small_t<int>{}};
+    delegate<int(int)> big_delegate{Big_t<int>{}};
+    inline_cache_stats stats;
+    THEN("expecting their types hits, other types miss") {
+      REQUIRE(small_delegate.invoke_expecting<Small_t<int>>(stats, 1) == 1);
+      REQUIRE(big_delegate.invoke_expecting<Big_t<int>>(stats, 2) == 2);
+      REQUIRE(small_delegate.invoke_expecting<Big_t<int>>(stats, 3) == 3);
+      REQUIRE(stats.hits == 2);
+      REQUIRE(stats.misses == 1);
+    }
+  }
+  GIVEN("an invalid delegate") {
+    delegate<int(int)> delegate;
+    THEN("nothing is expected to be bound") {
+      REQUIRE_FALSE(delegate.expect<&free_f_t<int>>());
+      REQUIRE(delegate.invoke_expecting<&free_f_t<int>>(7) == 0);
+    }
+  }
+}
+
+/// multiplies element-wise and has a vectorized overload for batches.
+struct BulkMultiply {
+  using bulk_overload = void;
+  float operator()(int a, float b) {
+    ++single_calls;
+    return a * b;
+  }
+  void operator()(bulk_t, span<const int> a, span<const float> b,
+                  span<float> out) {
+    ++bulk_calls;
+    for (size_t i = 0; i < out.size(); ++i)
+      out[i] = a[i] * b[i];
+  }
+  int single_calls{0};
+  int bulk_calls{0};
+};
+
+float multiply(int a, float b) { return a * b; }
+
+SCENARIO("delegate batch invocation") {
+  std::vector<int>   a{1, 2, 3, 4};
+  std::vector<float> b{0.5f, 1.0f, 1.5f, 2.0f};
+  std::vector<float> expected{0.5f, 2.0f, 4.5f, 8.0f};
+  std::vector<float> out(4);
+  GIVEN("a delegate bound to a free function") {
+    delegate<float(int, float)> delegate(&multiply);
+    delegate.invoke_n(a, b, out);
+    THEN("each element is processed") { REQUIRE(out == expected); }
+  }
+  GIVEN("a delegate bound to a function object with a vectorized overload") {
+    BulkMultiply                functor;
+    delegate<float(int, float)> delegate(std::ref(functor));
+    delegate.invoke_n(a, b, out);
+    THEN("the whole batch is passed to it at once") {
+      REQUIRE(out == expected);
+      REQUIRE(functor.bulk_calls == 1);
+      REQUIRE(functor.single_calls == 0);
+    }
+  }
+  GIVEN("a delegate bound to a big function object without one") {
+    delegate<float(int, float)> delegate(
+        [pad = Big_t<int>{}](int x, float y) { return x * y; });
+    WHEN("the spans have different sizes") {
+      std::vector<float> short_out(3, -1.0f);
+      delegate.invoke_n(a, b, short_out);
+      THEN("only the common prefix is processed") {
+        REQUIRE(short_out == std::vector<float>{0.5f, 2.0f, 4.5f});
+      }
+    }
+  }
+  GIVEN("a delegate returning void") {
+    int                  sum = 0;
+    delegate<void(int&)> delegate([&sum](int& x) { sum += x++; });
+    delegate.invoke_n(a);
+    THEN("the arguments are passed by reference") {
+      REQUIRE(sum == 10);
+      REQUIRE(a == std::vector<int>{2, 3, 4, 5});
+    }
+  }
+  GIVEN("a delegate bound to variadic generic lambdas") {
+    // binding must not instantiate the lambda bodies with bulk.
+    delegate<float(int, float)> sum(
+        [](auto... xs) { return (0.0f + ... + xs); });
+    delegate<float(int, float)> forward(
+        [](auto&&... xs) { return multiply(xs...); });
+    sum.invoke_n(a, b, out);
+    THEN("each element is processed") {
+      REQUIRE(out == std::vector<float>{1.5f, 3.0f, 4.5f, 6.0f});
+      forward.invoke_n(a, b, out);
+      REQUIRE(out == expected);
+    }
+  }
+  GIVEN("an invalid delegate") {
+    delegate<float(int, float)> delegate;
+    delegate.invoke_n(a, b, out);
+    THEN("the results are value initialized") {
+      REQUIRE(out == std::vector<float>(4, 0.0f));
+    }
+  }
+}
+
+/// a C library taking a callback and its context.
+extern "C" {
+typedef int (*c_api_callback_t)(void*, int);
+static int c_api_call(c_api_callback_t callback, void* context, int x) {
+  return callback(context, x);
+}
+static int c_api_add(void* context, int x) {
+  return *static_cast<int*>(context) + x;
+}
+}
+
+SCENARIO("delegate C callbacks") {
+  GIVEN("a delegate bound to a function object") {
+    int                offset = 3;
+    delegate<int(int)> delegate([&offset](int x) { return x + offset; });
+    WHEN("getting it as a C callback") {
+      auto callback = delegate.as_c_callback();
+      THEN("C code can call it directly") {
+        REQUIRE(callback.function != nullptr);
+        REQUIRE(callback.context != nullptr);
+        REQUIRE(c_api_call(callback.function, callback.context, 2) == 5);
+        REQUIRE(callback(4) == 7);
+        offset = 10;
+        REQUIRE(c_api_call(callback.function, callback.context, 2) == 12);
+      }
+    }
+  }
+  GIVEN("a C callback and its context") {
+    int offset = 5;
+    WHEN("constructing a delegate from it") {
+      delegate<int(int)> delegate(&c_api_add, &offset);
+      THEN("invoking it calls the function with the context") {
+        REQUIRE(delegate.is_valid());
+        REQUIRE(delegate(1) == 6);
+        offset = 7;
+        REQUIRE(delegate(1) == 8);
+      }
+      THEN("copies share the context") {
+        auto copy = delegate;
+        offset = 0;
+        REQUIRE(copy(2) == 2);
+      }
+      THEN("it can be converted back and forth") {
+        pc::delegate<int(int)> round_trip(delegate.as_c_callback());
+        REQUIRE(round_trip(1) == 6);
+      }
+    }
+    WHEN("binding it to an invalid delegate") {
+      delegate<int(int)> delegate;
+      delegate.bind(&c_api_add, &offset);
+      THEN("it becomes valid") { REQUIRE(delegate(2) == 7); }
+    }
+  }
+}
+
+/// a function object which is trivially copyable.
+struct plain_offset {
+  int offset;
+  int operator()(int x) const { return x + offset; }
+};
+
+/// a function object which is not trivially copyable, but fits inline.
+struct shared_offset {
+  std::shared_ptr<int> offset;
+  int                  operator()(int x) const { return x + *offset; }
+};
+
+SCENARIO("delegate introspection") {
+  GIVEN("an invalid delegate") {
+    delegate<int(int)> delegate;
+    THEN("nothing is stored") {
+      REQUIRE(delegate.storage_kind() == storage_kind::null);
+      REQUIRE_FALSE(delegate.target_type());
+      REQUIRE(delegate.target<int (*)(int)>() == nullptr);
+    }
+  }
+  GIVEN("a delegate bound to a free function") {
+    delegate<int(int)> delegate(&twice);
+    THEN("the function pointer is stored trivially") {
+      REQUIRE(delegate.storage_kind() == storage_kind::trivial);
+      REQUIRE(delegate.target_type() == type_id::of<int (*)(int)>());
+      REQUIRE(delegate.target<int (*)(int)>() != nullptr);
+      REQUIRE(*delegate.target<int (*)(int)>() == &twice);
+      REQUIRE(delegate.target<c_callback<int(int)>>() == nullptr);
+    }
+  }
+  GIVEN("a delegate bound to a C callback") {
+    int                offset = 1;
+    delegate<int(int)> delegate(&c_api_add, &offset);
+    THEN("the callback is stored trivially") {
+      REQUIRE(delegate.storage_kind() == storage_kind::trivial);
+      REQUIRE(delegate.target<c_callback<int(int)>>()->context == &offset);
+    }
+  }
+  GIVEN("delegates bound to function objects") {
+    auto                     lambda = [](int x) { return x; };
+    auto                     big = [pad = Big_t<int>{}](int x) { return x; };
+    shared_offset            shared{std::make_shared<int>(2)};
+    const delegate<int(int)> trivial(plain_offset{1});
+    delegate<int(int)>       with_lambda(lambda);
+    delegate<int(int)>       inplace(shared);
+    delegate<int(int)>       heap(big);
+    delegate<int(int)>       ref(std::ref(shared));
+    THEN("each reports how and what it stores") {
+      REQUIRE(trivial.storage_kind() == storage_kind::trivial);
+      REQUIRE(trivial.target<plain_offset>()->offset == 1);
+      REQUIRE(with_lambda.target<decltype(lambda)>() != nullptr);
+      REQUIRE(inplace.storage_kind() == storage_kind::inplace);
+      REQUIRE(inplace.target<shared_offset>() != nullptr);
+      REQUIRE(inplace.target<shared_offset>()->offset == shared.offset);
+      REQUIRE(heap.storage_kind() == storage_kind::heap);
+      REQUIRE(heap.target_type() == type_id::of<decltype(big)>());
+      REQUIRE(heap.target<decltype(big)>() != nullptr);
+      REQUIRE(heap.target<decltype(lambda)>() == nullptr);
+      REQUIRE(&ref.target<std::reference_wrapper<shared_offset>>()->get() ==
+              &shared);
+    }
+    WHEN("copying a delegate") {
+      auto copy = heap;
+      THEN("the copy stores its own callable of the same type") {
+        REQUIRE(copy.target_type() == heap.target_type());
+        REQUIRE(copy.target<decltype(big)>() != heap.target<decltype(big)>());
+      }
+    }
+  }
+}
+
+/// a function object too big to be stored inline, whose allocation can be
+/// made to fail.
+struct failing_alloc {
+  static inline bool fail = false;
+
+  static void* operator new(size_t size) { return ::operator new(size); }
+  static void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return fail ? nullptr : ::operator new(size);
+  }
+  static void operator delete(void* p) { ::operator delete(p); }
+
+  Big_t<int> pad;
+  int        value;
+  int        operator()(int x) const { return x + value; }
+};
+
+SCENARIO("delegate allocation failure") {
+  failing_alloc::fail = false;
+  GIVEN("a delegate bound to a free function") {
+    delegate<int(int)> delegate(&twice);
+    WHEN("try_bind fails to allocate") {
+      failing_alloc::fail = true;
+      const bool bound = delegate.try_bind(failing_alloc{{}, 1});
+      failing_alloc::fail = false;
+      THEN("it reports the failure and the delegate is unchanged") {
+        REQUIRE_FALSE(bound);
+        REQUIRE(delegate(2) == 4);
+      }
+    }
+    WHEN("try_bind succeeds") {
+      REQUIRE(delegate.try_bind(failing_alloc{{}, 1}));
+      THEN("the function object is bound") {
+        REQUIRE(delegate.storage_kind() == storage_kind::heap);
+        REQUIRE(delegate(2) == 3);
+      }
+    }
+    WHEN("try_bind binds a small function object") {
+      REQUIRE(delegate.try_bind([](int x) { return -x; }));
+      THEN("it is stored inline") { REQUIRE(delegate(2) == -2); }
+    }
+  }
+  GIVEN("a delegate bound to a heap allocated function object") {
+    delegate<int(int)> source(failing_alloc{{}, 5});
+    delegate<int(int)> target(&twice);
+    WHEN("try_copy fails to allocate") {
+      failing_alloc::fail = true;
+      const bool copied = target.try_copy(source);
+      failing_alloc::fail = false;
+      THEN("it reports the failure and the delegate is unchanged") {
+        REQUIRE_FALSE(copied);
+        REQUIRE(target(2) == 4);
+        REQUIRE(source(2) == 7);
+      }
+    }
+    WHEN("try_copy succeeds") {
+      REQUIRE(target.try_copy(source));
+      THEN("the delegate holds its own copy") {
+        REQUIRE(target(2) == 7);
+        REQUIRE(target.target<failing_alloc>() !=
+                source.target<failing_alloc>());
+      }
+    }
+#ifdef PC_DELEGATE_NO_EXCEPTIONS
+    WHEN("copy constructing fails to allocate") {
+      failing_alloc::fail = true;
+      pc::delegate<int(int)> copy(source);
+      failing_alloc::fail = false;
+      THEN("the copy is invalid") {
+        REQUIRE_FALSE(copy.is_valid());
+        REQUIRE(source(2) == 7);
+      }
+    }
+    WHEN("binding fails to allocate") {
+      failing_alloc::fail = true;
+      target.bind(failing_alloc{{}, 1});
+      failing_alloc::fail = false;
+      THEN("the delegate is invalid") { REQUIRE_FALSE(target.is_valid()); }
+    }
+#endif
+  }
+}
@@ -0,0 +1,65 @@
+/**
+ * @file event_bus.t.cpp
+ * @author Pele Constam (pelectron1602@gmail.com)
+ * @brief This file contains the tests for the event_bus class.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "event_bus.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace pc;
+
+namespace {
+  struct key_pressed : event<2, void(int)> {};
+  struct resized : event<0, int(int, int)> {};
+  struct renamed {
+    static constexpr size_t id = 1;
+    using signature = void(const std::string&);
+  };
+} // namespace
+
+#include "catch2/catch.hpp"
+SCENARIO("testing event_bus") {
+  GIVEN("an event_bus with three events") {
+    using bus_t = event_bus<key_pressed, resized, renamed>;
+    bus_t bus;
+    STATIC_REQUIRE(bus_t::num_events() == 3);
+    STATIC_REQUIRE(bus_t::index_of<key_pressed>() == 2);
+    STATIC_REQUIRE(bus_t::index_of<resized>() == 0);
+    STATIC_REQUIRE(bus_t::index_of<renamed>() == 1);
+    STATIC_REQUIRE(impl::are_dense_ids<1, 0, 2>());
+    STATIC_REQUIRE_FALSE(impl::are_dense_ids<0, 0, 1>());
+    STATIC_REQUIRE_FALSE(impl::are_dense_ids<0, 2>());
+    std::vector<int> keys;
+    std::string      name;
+    auto             key_id =
+        bus.subscribe<key_pressed>([&keys](int k) { keys.push_back(k); });
+    bus.subscribe<resized>([](int w, int h) { return w * h; });
+    bus.subscribe<renamed>([&name](const std::string& n) { name = n; });
+    WHEN("publishing events") {
+      bus.publish<key_pressed>(1);
+      bus.publish<resized>(3, 4);
+      bus.publish<renamed>("bus");
+      THEN("only the channel of each event is invoked") {
+        REQUIRE(keys == std::vector<int>{1});
+        REQUIRE(bus.channel<resized>().num_results() == 1);
+        REQUIRE(*bus.channel<resized>().begin() == 12);
+        REQUIRE(name == "bus");
+      }
+    }
+    WHEN("unsubscribing") {
+      REQUIRE(bus.unsubscribe<key_pressed>(key_id));
+      REQUIRE_FALSE(bus.unsubscribe<key_pressed>(key_id));
+      bus.publish<key_pressed>(2);
+      THEN("the callable is not invoked anymore") { REQUIRE(keys.empty()); }
+    }
+  }
+}
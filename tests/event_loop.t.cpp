@@ -0,0 +1,217 @@
+/**
+ * @file event_loop.t.cpp
+ * @author Pele Constam (pelectron1602@gmail.com)
+ * @brief This file contains the tests for the event_loop class. Only built on
+ * Linux.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "event_loop.hpp"
+
+#include <atomic>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace pc;
+
+#include "catch2/catch.hpp"
+
+/// a pipe which is closed on destruction.
+struct test_pipe {
+  test_pipe() { REQUIRE(pipe(fds) == 0); }
+  ~test_pipe() {
+    close(fds[0]);
+    close(fds[1]);
+  }
+  void put(char c = 'x') { REQUIRE(write(fds[1], &c, 1) == 1); }
+  char get() {
+    char c = 0;
+    REQUIRE(read(fds[0], &c, 1) == 1);
+    return c;
+  }
+  int read_end() const { return fds[0]; }
+  int fds[2];
+};
+
+SCENARIO("testing event_loop") {
+  GIVEN("an event_loop and a pipe") {
+    event_loop loop;
+    test_pipe  p;
+    std::vector<char> received;
+    loop.add(p.read_end(), EPOLLIN, [&](int fd, uint32_t events) {
+      REQUIRE(fd == p.read_end());
+      REQUIRE((events & EPOLLIN) != 0);
+      received.push_back(p.get());
+    });
+    WHEN("nothing is written") {
+      THEN("the handler is not called") {
+        REQUIRE(loop.run_once(0) == 0);
+        REQUIRE(received.empty());
+      }
+    }
+    WHEN("writing to the pipe") {
+      p.put('a');
+      THEN("the handler is called") {
+        REQUIRE(loop.run_once(1000) == 1);
+        REQUIRE(received == std::vector<char>{'a'});
+      }
+    }
+    WHEN("removing the pipe") {
+      loop.remove(p.read_end());
+      p.put();
+      THEN("the handler is not called anymore") {
+        REQUIRE(loop.run_once(0) == 0);
+        REQUIRE(received.empty());
+      }
+    }
+    WHEN("watching for no events") {
+      loop.modify(p.read_end(), 0);
+      p.put();
+      THEN("the handler is not called until the events are restored") {
+        REQUIRE(loop.run_once(0) == 0);
+        loop.modify(p.read_end(), EPOLLIN);
+        REQUIRE(loop.run_once(1000) == 1);
+      }
+    }
+#ifndef PC_DELEGATE_NO_EXCEPTIONS
+    WHEN("adding it twice") {
+      THEN("an exception is thrown") {
+        REQUIRE_THROWS_AS(loop.add(p.read_end(), EPOLLIN, [](int, uint32_t) {}),
+                          std::system_error);
+      }
+    }
+#endif
+  }
+  GIVEN("an event_loop and a socketpair") {
+    event_loop loop;
+    int        sv[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+    int replies = 0;
+    WHEN("the handler removes and re-adds itself") {
+      loop.add(sv[0], EPOLLIN, [&](int fd, uint32_t) {
+        char c;
+        REQUIRE(read(fd, &c, 1) == 1);
+        loop.remove(fd);
+        loop.add(fd, EPOLLIN, [&replies](int fd2, uint32_t) {
+          char c2;
+          REQUIRE(read(fd2, &c2, 1) == 1);
+          REQUIRE(write(fd2, &c2, 1) == 1);
+          ++replies;
+        });
+      });
+      char c = 'q';
+      REQUIRE(write(sv[1], &c, 1) == 1);
+      REQUIRE(loop.run_once(1000) == 1);
+      THEN("the new handler gets the next events") {
+        REQUIRE(write(sv[1], &c, 1) == 1);
+        REQUIRE(loop.run_once(1000) == 1);
+        REQUIRE(replies == 1);
+        REQUIRE(read(sv[1], &c, 1) == 1);
+        REQUIRE(c == 'q');
+      }
+    }
+    WHEN("a handler removes another fd whose event is in the same batch") {
+      int calls = 0;
+      loop.add(sv[0], EPOLLIN, [&](int, uint32_t) {
+        ++calls;
+        loop.remove(sv[1]);
+      });
+      loop.add(sv[1], EPOLLIN, [&](int, uint32_t) {
+        ++calls;
+        loop.remove(sv[0]);
+      });
+      char c = 'x';
+      REQUIRE(write(sv[0], &c, 1) == 1);
+      REQUIRE(write(sv[1], &c, 1) == 1);
+      THEN("only one of the handlers is called") {
+        REQUIRE(loop.run_once(1000) == 1);
+        REQUIRE(calls == 1);
+      }
+    }
+    close(sv[0]);
+    close(sv[1]);
+  }
+  GIVEN("an event_loop running on another thread") {
+    event_loop       loop;
+    std::atomic<int> count{0};
+    std::thread      t([&loop] { loop.run(); });
+    WHEN("posting tasks from several threads") {
+      std::vector<std::thread> posters;
+      for (int i = 0; i < 4; ++i) {
+        posters.emplace_back([&] {
+          for (int j = 0; j < 1000; ++j)
+            loop.post([&count] { count.fetch_add(1); });
+        });
+      }
+      for (auto& p : posters)
+        p.join();
+      THEN("all of them run on the loop") {
+        while (count.load() != 4000)
+          std::this_thread::yield();
+        REQUIRE(count.load() == 4000);
+      }
+    }
+    loop.stop();
+    t.join();
+  }
+#ifndef PC_DELEGATE_NO_EXCEPTIONS
+  GIVEN("an event_loop with a posted task which throws") {
+    event_loop loop;
+    int        count = 0;
+    loop.post([&count] { ++count; });
+    loop.post([] { throw 1; });
+    loop.post([&count] { ++count; });
+    WHEN("running it") {
+      REQUIRE_THROWS_AS(loop.run_once(0), int);
+      THEN("the following tasks run once, on the next run") {
+        REQUIRE(count == 1);
+        REQUIRE(loop.run_once(0) == 1);
+        REQUIRE(count == 2);
+        REQUIRE(loop.run_once(0) == 0);
+        loop.post([&count] { ++count; });
+        REQUIRE(loop.run_once(1000) == 1);
+        REQUIRE(count == 3);
+      }
+    }
+  }
+  GIVEN("an event_loop with edge triggered handlers of which one throws") {
+    event_loop loop;
+    int        sv[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+    int  calls = 0;
+    int  tasks = 0;
+    auto handler = [&calls](int, uint32_t) {
+      if (calls++ == 0)
+        throw 1;
+    };
+    loop.add(sv[0], EPOLLIN | EPOLLET, handler);
+    loop.add(sv[1], EPOLLIN | EPOLLET, handler);
+    char c = 'x';
+    REQUIRE(write(sv[0], &c, 1) == 1);
+    REQUIRE(write(sv[1], &c, 1) == 1);
+    loop.post([&tasks] { ++tasks; });
+    WHEN("running it") {
+      REQUIRE_THROWS_AS(loop.run_once(1000), int);
+      THEN("the next run dispatches the rest of the batch and the tasks") {
+        REQUIRE(calls == 1);
+        REQUIRE(tasks == 0);
+        REQUIRE(loop.run_once(1000) == 2);
+        REQUIRE(calls == 2);
+        REQUIRE(tasks == 1);
+        REQUIRE(loop.run_once(0) == 0);
+      }
+    }
+    close(sv[0]);
+    close(sv[1]);
+  }
+#endif
+}
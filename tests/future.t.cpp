@@ -0,0 +1,314 @@
+/**
+ * @file future.t.cpp
+ * @author Pele Constam (pelectron1602@gmail.com)
+ * @brief This file contains the tests for delegate::invoke_async(),
+ * multicast_delegate::invoke_async(), pc::future and pc::when_all().
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "future.hpp"
+#include "multicast_delegate.hpp"
+#include "task_scheduler.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace pc;
+
+#include "catch2/catch.hpp"
+
+/// runs every task inline, i.e. futures are ready once invoke_async returns.
+struct inline_executor {
+  void submit(delegate<void()> task) { task(); }
+  bool try_run_one() { return false; }
+};
+
+/// holds on to the tasks until run() is called.
+struct manual_executor {
+  void submit(delegate<void()> task) { tasks.push_back(std::move(task)); }
+  void run() {
+    for (auto& t : tasks)
+      t();
+    tasks.clear();
+  }
+  std::vector<delegate<void()>> tasks;
+};
+
+SCENARIO("testing delegate::invoke_async") {
+  GIVEN("a delegate and a manual_executor") {
+    manual_executor              executor;
+    delegate<int(int, int)>      add([](int a, int b) { return a + b; });
+    WHEN("invoking it asynchronously") {
+      auto f = add.invoke_async(executor, 1, 2);
+      THEN("the future is ready once the executor ran the task") {
+        REQUIRE(f.valid());
+        REQUIRE_FALSE(f.is_ready());
+        executor.run();
+        REQUIRE(f.is_ready());
+        REQUIRE(f.get() == 3);
+      }
+    }
+    WHEN("the arguments are references to temporaries") {
+      delegate<size_t(const std::string&)> size(
+          [](const std::string& s) { return s.size(); });
+      auto f = size.invoke_async(executor, std::string("hello"));
+      executor.run();
+      THEN("the arguments were copied") { REQUIRE(f.get() == 5); }
+    }
+    WHEN("registering a callback before the value is ready") {
+      int  value = 0;
+      auto f = add.invoke_async(executor, 3, 4);
+      f.then([&value](int v) { value = v; });
+      REQUIRE_FALSE(f.valid());
+      REQUIRE(value == 0);
+      executor.run();
+      THEN("the callback is called with the value") { REQUIRE(value == 7); }
+    }
+    WHEN("registering a callback after the value is ready") {
+      int  value = 0;
+      auto f = add.invoke_async(executor, 5, 6);
+      executor.run();
+      f.then([&value](int v) { value = v; });
+      THEN("the callback is called right away") { REQUIRE(value == 11); }
+    }
+  }
+  GIVEN("delegates returning void and references") {
+    inline_executor executor;
+    int             x = 0;
+    delegate<void(int)> set([&x](int v) { x = v; });
+    delegate<int&()>    ref([&x]() -> int& { return x; });
+    THEN("void futures become ready") {
+      auto f = set.invoke_async(executor, 42);
+      REQUIRE(f.is_ready());
+      f.get();
+      REQUIRE(x == 42);
+    }
+    THEN("reference futures return the reference") {
+      auto f = ref.invoke_async(executor);
+      REQUIRE(&f.get() == &x);
+    }
+  }
+  GIVEN("a thread_pool") {
+    thread_pool      pool(2);
+    std::atomic<int> count{0};
+    delegate<int(int)> square([&count](int v) {
+      count.fetch_add(1);
+      return v * v;
+    });
+    THEN("many invocations complete with the right values") {
+      std::vector<future<int>> futures;
+      for (int i = 0; i < 1000; ++i)
+        futures.push_back(square.invoke_async(pool, i));
+      for (int i = 0; i < 1000; ++i) {
+        futures[i].wait(pool);
+        REQUIRE(futures[i].get() == i * i);
+      }
+      REQUIRE(count.load() == 1000);
+    }
+  }
+#ifndef PC_DELEGATE_NO_EXCEPTIONS
+  GIVEN("a delegate which throws") {
+    manual_executor    executor;
+    delegate<int(int)> fail([](int v) -> int {
+      if (v < 0)
+        throw std::runtime_error("negative");
+      return v;
+    });
+    WHEN("invoking it asynchronously") {
+      auto f = fail.invoke_async(executor, -1);
+      executor.run();
+      THEN("the future is ready and get() rethrows") {
+        REQUIRE(f.is_ready());
+        REQUIRE_THROWS_AS(f.get(), std::runtime_error);
+      }
+    }
+    WHEN("registering a callback after the value is ready") {
+      bool called = false;
+      auto f = fail.invoke_async(executor, -1);
+      executor.run();
+      THEN("the callback is not called and the exception is discarded") {
+        REQUIRE_NOTHROW(f.then([&called](int) { called = true; }));
+        REQUIRE_FALSE(called);
+      }
+    }
+    WHEN("registering callbacks before the value is ready") {
+      bool               called = false;
+      std::exception_ptr error;
+      auto               f = fail.invoke_async(executor, -1);
+      f.then([&called](int) { called = true; },
+             [&error](std::exception_ptr e) { error = e; });
+      executor.run();
+      THEN("the error callback gets the exception") {
+        REQUIRE_FALSE(called);
+        REQUIRE(error);
+        REQUIRE_THROWS_AS(std::rethrow_exception(error), std::runtime_error);
+      }
+    }
+    WHEN("registering callbacks for a call which succeeds") {
+      int  value = 0;
+      bool failed = false;
+      auto f = fail.invoke_async(executor, 2);
+      f.then([&value](int v) { value = v; },
+             [&failed](std::exception_ptr) { failed = true; });
+      executor.run();
+      THEN("the value callback is called") {
+        REQUIRE(value == 2);
+        REQUIRE_FALSE(failed);
+      }
+    }
+    WHEN("registering callbacks before a thread_pool invokes it") {
+      std::atomic<bool> failed{false};
+      std::atomic<bool> called{false};
+      {
+        thread_pool pool(2);
+        for (int i = 0; i < 100; ++i) {
+          fail.invoke_async(pool, -1).then(
+              [&called](int) { called = true; },
+              [&failed](std::exception_ptr) { failed = true; });
+          fail.invoke_async(pool, -1).then([&called](int) { called = true; });
+        }
+      }
+      THEN("the workers pass the exception on instead of throwing") {
+        REQUIRE(failed.load());
+        REQUIRE_FALSE(called.load());
+      }
+    }
+    WHEN("invoking it on a thread_pool") {
+      thread_pool pool(2);
+      auto        f = fail.invoke_async(pool, -1);
+      f.wait(pool);
+      THEN("the exception reaches the caller") {
+        REQUIRE_THROWS_AS(f.get(), std::runtime_error);
+        AND_THEN("the pool keeps working") {
+          auto g = fail.invoke_async(pool, 3);
+          g.wait(pool);
+          REQUIRE(g.get() == 3);
+        }
+      }
+    }
+  }
+#endif
+}
+
+SCENARIO("testing when_all") {
+  GIVEN("futures of a manual_executor") {
+    manual_executor          executor;
+    delegate<int(int)>       twice([](int v) { return 2 * v; });
+    std::vector<future<int>> futures;
+    for (int i = 0; i < 4; ++i)
+      futures.push_back(twice.invoke_async(executor, i));
+    auto all = when_all(std::move(futures));
+    THEN("the combined future is ready once all inputs are") {
+      REQUIRE_FALSE(all.is_ready());
+      executor.run();
+      REQUIRE(all.is_ready());
+      REQUIRE(all.get() == std::vector<int>{0, 2, 4, 6});
+    }
+  }
+#ifndef PC_DELEGATE_NO_EXCEPTIONS
+  GIVEN("futures of which one throws") {
+    manual_executor          executor;
+    delegate<int(int)>       fail([](int v) -> int {
+      if (v == 2)
+        throw std::runtime_error("two");
+      return v;
+    });
+    std::vector<future<int>> futures;
+    for (int i = 0; i < 4; ++i)
+      futures.push_back(fail.invoke_async(executor, i));
+    auto all = when_all(std::move(futures));
+    executor.run();
+    THEN("the combined future rethrows the exception") {
+      REQUIRE(all.is_ready());
+      REQUIRE_THROWS_AS(all.get(), std::runtime_error);
+    }
+  }
+#endif
+  GIVEN("no futures") {
+    auto all = when_all(std::vector<future<void>>{});
+    THEN("the combined future is ready") { REQUIRE(all.is_ready()); }
+  }
+}
+
+SCENARIO("testing multicast_delegate::invoke_async") {
+  GIVEN("a multicast_delegate with several callables") {
+    multicast_delegate<int(int)> md;
+    for (int i = 0; i < 8; ++i)
+      md.bind([i](int v) { return v + i; });
+    WHEN("invoking it on a task_scheduler") {
+      task_scheduler scheduler(2);
+      auto           f = md.invoke_async(scheduler, 10);
+      f.wait(scheduler);
+      THEN("the values are in the order of the callables") {
+        REQUIRE(f.get() ==
+                std::vector<int>{10, 11, 12, 13, 14, 15, 16, 17});
+        REQUIRE(md.num_results() == 0);
+      }
+    }
+    WHEN("invoking it repeatedly") {
+      thread_pool pool(2);
+      long        total = 0;
+      for (int round = 0; round < 100; ++round) {
+        auto f = md.invoke_async(pool, round);
+        f.wait(pool);
+        for (int v : f.get())
+          total += v;
+      }
+      THEN("every round collected all values") {
+        // sum over rounds of (8 * round + 28)
+        REQUIRE(total == 8 * 4950 + 28 * 100);
+      }
+    }
+  }
+  GIVEN("a multicast_delegate returning void") {
+    multicast_delegate<void(int)> md;
+    std::atomic<int>              sum{0};
+    for (int i = 0; i < 4; ++i)
+      md.bind([&sum](int v) { sum.fetch_add(v); });
+    inline_executor executor;
+    auto            f = md.invoke_async(executor, 3);
+    THEN("the future is ready once all callables returned") {
+      REQUIRE(f.is_ready());
+      REQUIRE(sum.load() == 12);
+    }
+  }
+}
+
+SCENARIO("testing impl::object_pool") {
+  struct pooled {
+    int value{0};
+  };
+  using pool_t = impl::object_pool<pooled>;
+  GIVEN("objects acquired on one thread") {
+    std::vector<pooled*> objects;
+    for (int i = 0; i < 100; ++i)
+      objects.push_back(pool_t::acquire());
+    WHEN("releasing them on a thread which exits") {
+      std::thread([&objects] {
+        for (auto* o : objects)
+          pool_t::release(o);
+      }).join();
+      THEN("the acquiring thread gets them back") {
+        std::vector<pooled*> reused;
+        for (size_t i = 0; i < objects.size(); ++i)
+          reused.push_back(pool_t::acquire());
+        std::sort(objects.begin(), objects.end());
+        std::sort(reused.begin(), reused.end());
+        REQUIRE(reused == objects);
+        for (auto* o : reused)
+          pool_t::release(o);
+      }
+    }
+  }
+}
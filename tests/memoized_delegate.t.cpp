@@ -0,0 +1,134 @@
+/**
+ * @file memoized_delegate.t.cpp
+ * @author Pele Constam (pelectron1602@gmail.com)
+ * @brief This file contains the tests for the memoized_delegate class.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "memoized_delegate.hpp"
+#include "multicast_delegate.hpp"
+
+#include <functional>
+#include <string>
+
+using namespace pc;
+
+#include "catch2/catch.hpp"
+
+/// a pure function which counts its invocations.
+struct counting_square {
+  int* calls;
+  int  operator()(int x) const {
+    ++*calls;
+    return x * x;
+  }
+};
+
+SCENARIO("testing memoized_delegate") {
+  GIVEN("a memoized_delegate with capacity 4") {
+    int                         calls = 0;
+    memoized_delegate<int(int)> memo(4, counting_square{&calls});
+    REQUIRE(memo.capacity() == 4);
+    REQUIRE(memo.is_valid());
+    WHEN("invoking it twice with the same argument") {
+      REQUIRE(memo(3) == 9);
+      REQUIRE(memo(3) == 9);
+      THEN("the callable is invoked once") {
+        REQUIRE(calls == 1);
+        REQUIRE(memo.size() == 1);
+        REQUIRE(memo.stats().hits == 1);
+        REQUIRE(memo.stats().misses == 1);
+        REQUIRE(memo.stats().hit_rate() == 0.5);
+      }
+    }
+    WHEN("invoking it with more arguments than fit") {
+      for (int i = 0; i < 4; ++i)
+        memo(i);
+      // reference 0 and 1, so that the clock evicts 2 first, then 3.
+      memo(0);
+      memo(1);
+      memo(10);
+      memo(11);
+      THEN("the unreferenced results are evicted") {
+        REQUIRE(memo.size() == 4);
+        REQUIRE(memo.evictions() == 2);
+        calls = 0;
+        REQUIRE(memo(0) == 0);
+        REQUIRE(memo(1) == 1);
+        REQUIRE(memo(10) == 100);
+        REQUIRE(memo(11) == 121);
+        REQUIRE(calls == 0);
+        REQUIRE(memo(2) == 4);
+        REQUIRE(calls == 1);
+      }
+    }
+    WHEN("binding another callable") {
+      memo(2);
+      memo.bind([](int x) { return -x; });
+      THEN("the cache is invalidated") {
+        REQUIRE(memo.size() == 0);
+        REQUIRE(memo(2) == -2);
+      }
+    }
+    WHEN("resetting it") {
+      memo(2);
+      memo.reset();
+      THEN("the cache is invalidated and nothing is bound") {
+        REQUIRE_FALSE(memo.is_valid());
+        REQUIRE(memo.size() == 0);
+        REQUIRE(memo(2) == 0);
+      }
+    }
+  }
+  GIVEN("a memoized_delegate with more than one argument") {
+    int                                              calls = 0;
+    memoized_delegate<std::string(std::string, int)> memo(
+        64, [&calls](const std::string& s, int n) {
+          ++calls;
+          std::string r;
+          for (int i = 0; i < n; ++i)
+            r += s;
+          return r;
+        });
+    WHEN("invoking it with many argument combinations, twice") {
+      for (int round = 0; round < 2; ++round) {
+        for (int i = 0; i < 48; ++i) {
+          const std::string s = std::to_string(i);
+          const std::string expected[] = {"", s, s + s};
+          REQUIRE(memo(s, i % 3) == expected[i % 3]);
+        }
+      }
+      THEN("every combination is computed once") {
+        REQUIRE(calls == 48);
+        REQUIRE(memo.stats().hits == 48);
+      }
+    }
+    WHEN("the cache overflows many times") {
+      for (int i = 0; i < 10000; ++i)
+        memo(std::to_string(i % 500), 1);
+      THEN("the results stay correct") {
+        REQUIRE(memo.size() == 64);
+        for (int i = 0; i < 500; ++i)
+          REQUIRE(memo(std::to_string(i), 1) == std::to_string(i));
+      }
+    }
+  }
+  GIVEN("a memoized_delegate subscribed to a multicast_delegate") {
+    int                          calls = 0;
+    memoized_delegate<int(int)>  memo(16, counting_square{&calls});
+    multicast_delegate<int(int)> multicast;
+    multicast.bind(std::ref(memo));
+    multicast(5);
+    multicast(5);
+    THEN("emitting uses its cache") {
+      REQUIRE(calls == 1);
+      REQUIRE(multicast.num_results() == 2);
+      REQUIRE(memo.stats().hits == 1);
+    }
+  }
+}
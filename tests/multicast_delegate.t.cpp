@@ -1,4 +1,11 @@
 #include "multicast_delegate.hpp"
+#include "thread_pool.hpp"
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
 using namespace pc;
 
 int free_func(int a) { return a; }
@@ -37,4 +44,301 @@ SCENARIO("testing multicast_delegate") {
       }
     }
   }
-}
\ No newline at end of file
+}
+SCENARIO("testing multicast_delegate priorities and groups") {
+  GIVEN("callables bound with different priorities") {
+    delegate_t del;
+    del.bind([](int a) { return a; });
+    del.bind(10, [](int a) { return a + 10; });
+    del.bind(-5, [](int a) { return a - 5; });
+    del.bind(10, [](int a) { return a + 11; });
+    del.bind([](int a) { return a + 1; });
+    REQUIRE(del.num_callables() == 5);
+    WHEN("invoking the delegate") {
+      del(0);
+      THEN("higher priorities run first and equal priorities keep bind order") {
+        std::vector<int> results(del.begin(), del.end());
+        REQUIRE(results == std::vector<int>{10, 11, 0, 1, -5});
+      }
+    }
+  }
+  GIVEN("callables bound into groups") {
+    delegate_t del;
+    del.bind_to_group("metrics", 5, [](int a) { return a + 5; });
+    del.bind([](int a) { return a; });
+    del.bind_to_group("cache", 1, [](int a) { return a + 1; });
+    del.bind_to_group("metrics", -1, [](int a) { return a - 1; });
+    REQUIRE(del.num_callables() == 4);
+    WHEN("disabling a group") {
+      del.disable_group("metrics");
+      REQUIRE_FALSE(del.is_group_enabled("metrics"));
+      REQUIRE(del.is_group_enabled("cache"));
+      del(0);
+      THEN("its callables are not invoked") {
+        REQUIRE(del.num_callables() == 2);
+        std::vector<int> results(del.begin(), del.end());
+        REQUIRE(results == std::vector<int>{1, 0});
+      }
+      AND_WHEN("binding to the disabled group and enabling it again") {
+        del.bind_to_group("metrics", 1, [](int a) { return a + 2; });
+        REQUIRE(del.num_callables() == 2);
+        del.enable_group("metrics");
+        del.clear_results();
+        del(0);
+        THEN("the callables are invoked in priority and bind order") {
+          REQUIRE(del.num_callables() == 5);
+          std::vector<int> results(del.begin(), del.end());
+          REQUIRE(results == std::vector<int>{5, 1, 2, 0, -1});
+        }
+      }
+    }
+    WHEN("disabling a group which does not exist yet") {
+      del.disable_group("audit");
+      del.bind_to_group("audit", 0, [](int a) { return a + 100; });
+      THEN("callables bound to it start out disabled") {
+        REQUIRE_FALSE(del.is_group_enabled("audit"));
+        REQUIRE(del.num_callables() == 4);
+      }
+    }
+  }
+}
+
+SCENARIO("testing multicast_delegate re-entrancy") {
+  GIVEN("a callable which binds to the delegate it is invoked from") {
+    delegate_t del;
+    del.bind([&del](int a) {
+      del.bind([](int b) { return b + 1; });
+      return a;
+    });
+    WHEN("invoking the delegate") {
+      del(0);
+      THEN("the new callable is bound after the invocation") {
+        REQUIRE(del.num_results() == 1);
+        REQUIRE(del.num_callables() == 2);
+      }
+      AND_WHEN("invoking it again") {
+        del.clear_results();
+        del(0);
+        THEN("the new callables are invoked") {
+          REQUIRE(del.num_callables() == 3);
+          std::vector<int> results(del.begin(), del.end());
+          REQUIRE(results == std::vector<int>{0, 1});
+        }
+      }
+    }
+  }
+  GIVEN("a callable which unbinds itself and invokes the delegate again") {
+    delegate_t                  del;
+    delegate_t::subscription_id self{};
+    int                         depth = 0;
+    del.bind([](int a) { return a; });
+    self = del.bind([&](int a) {
+      if (depth++ == 0) {
+        REQUIRE(del.unbind(self));
+        del(a + 10);
+      }
+      return a + 1;
+    });
+    WHEN("invoking the delegate") {
+      del(0);
+      THEN("the nested invocation still sees all callables") {
+        std::vector<int> results(del.begin(), del.end());
+        REQUIRE(results == std::vector<int>{0, 10, 11, 1});
+        REQUIRE(del.num_callables() == 1);
+        REQUIRE_FALSE(del.unbind(self));
+      }
+    }
+  }
+  GIVEN("a callable which unbinds itself twice") {
+    delegate_t                  del;
+    delegate_t::subscription_id self{};
+    std::vector<bool>           unbound;
+    self = del.bind([&](int a) {
+      unbound.push_back(del.unbind(self));
+      unbound.push_back(del.unbind(self));
+      return a;
+    });
+    del.bind([](int a) { return a + 1; });
+    WHEN("invoking the delegate") {
+      del(0);
+      THEN("only the first unbind succeeds") {
+        REQUIRE(unbound == std::vector<bool>{true, false});
+        REQUIRE(del.num_callables() == 1);
+      }
+    }
+  }
+#ifndef PC_DELEGATE_NO_EXCEPTIONS
+  GIVEN("a callable which binds another one and throws") {
+    delegate_t del;
+    del.bind([&del](int a) -> int {
+      del.bind([](int b) { return b + 1; });
+      throw a;
+    });
+    WHEN("invoking the delegate") {
+      REQUIRE_THROWS_AS(del(1), int);
+      THEN("the binding is applied before the next modification") {
+        REQUIRE(del.num_callables() == 1);
+        del.bind([](int b) { return b + 2; });
+        REQUIRE(del.num_callables() == 3);
+        del.reset();
+        REQUIRE(del.num_callables() == 0);
+      }
+    }
+  }
+#endif
+  GIVEN("a callable which disables its own group and resets the delegate") {
+    delegate_t del;
+    del.bind_to_group("group", 0, [&del](int a) {
+      del.disable_group("group");
+      del.reset();
+      del.bind([](int b) { return b * 2; });
+      return a;
+    });
+    WHEN("invoking the delegate") {
+      del(3);
+      THEN("the changes are applied in order after the invocation") {
+        REQUIRE(del.num_results() == 1);
+        REQUIRE_FALSE(del.is_group_enabled("group"));
+        REQUIRE(del.num_callables() == 1);
+        del(3);
+        REQUIRE(*(del.begin() + 1) == 6);
+      }
+    }
+  }
+  GIVEN("a callable which copies the delegate it is invoked from") {
+    delegate_t                  del;
+    std::unique_ptr<delegate_t> copy;
+    del.bind([&](int a) {
+      copy = std::make_unique<delegate_t>(del);
+      return a;
+    });
+    del(0);
+    WHEN("binding to the copy") {
+      copy->bind([](int b) { return b + 1; });
+      THEN("the copy is not being invoked and binds right away") {
+        REQUIRE(copy->num_callables() == 2);
+        REQUIRE(del.num_callables() == 1);
+      }
+    }
+  }
+}
+
+SCENARIO("testing multicast_delegate parallel invocation") {
+  GIVEN("a delegate with many callables and a thread_pool") {
+    thread_pool pool(3);
+    delegate_t  del;
+    for (int i = 0; i < 1000; ++i)
+      del.bind([i](int a) { return a + i; });
+    WHEN("invoking it in parallel") {
+      del.parallel_invoke(pool, 5);
+      THEN("the results are the same as those of a serial invocation") {
+        REQUIRE(del.num_results() == 1000);
+        int i = 0;
+        for (const auto &res : del)
+          REQUIRE(res == 5 + i++);
+      }
+    }
+  }
+  GIVEN("a delegate returning void") {
+    thread_pool                pool(2);
+    multicast_delegate<void()> del;
+    std::atomic<int>           count{0};
+    for (int i = 0; i < 100; ++i)
+      del.bind([&count] { count.fetch_add(1); });
+    WHEN("invoking it in parallel") {
+      del.parallel_invoke(pool);
+      THEN("every callable was invoked once") { REQUIRE(count.load() == 100); }
+    }
+  }
+#ifndef PC_DELEGATE_NO_EXCEPTIONS
+  GIVEN("a delegate with a callable which throws") {
+    thread_pool      pool(3);
+    delegate_t       del;
+    std::atomic<int> count{0};
+    bool             fail = true;
+    for (int i = 0; i < 1000; ++i) {
+      del.bind([i, &count, &fail](int a) {
+        if (fail && i == 500)
+          throw std::runtime_error("500");
+        count.fetch_add(1);
+        return a + i;
+      });
+    }
+    WHEN("invoking it in parallel") {
+      REQUIRE_THROWS_AS(del.parallel_invoke(pool, 5), std::runtime_error);
+      THEN("the callables before it ran and no results were added") {
+        REQUIRE(count.load() >= 500);
+        REQUIRE(count.load() < 1000);
+        REQUIRE(del.num_results() == 0);
+        AND_THEN("the delegate and the pool can be used again") {
+          fail = false;
+          del.parallel_invoke(pool, 5);
+          REQUIRE(del.num_results() == 1000);
+        }
+      }
+    }
+  }
+#endif
+}
+
+SCENARIO("testing multicast_delegate batch invocation") {
+  GIVEN("a delegate with a few callables") {
+    delegate_t del;
+    del.bind([](int a) { return a; });
+    del.bind([](int a) { return 10 * a; });
+    WHEN("invoking it with a batch of events") {
+      std::vector<std::tuple<int>> events{{1}, {2}, {3}};
+      del.invoke_batch(events);
+      THEN("the results are stored callable-major") {
+        std::vector<int> results(del.begin(), del.end());
+        REQUIRE(results == std::vector<int>{1, 2, 3, 10, 20, 30});
+      }
+    }
+    WHEN("invoking it with an empty batch") {
+      del.invoke_batch(std::vector<std::tuple<int>>{});
+      THEN("there are no results") { REQUIRE(del.num_results() == 0); }
+    }
+  }
+}
+
+namespace {
+  /// counts how often it is copied.
+  struct CopyCounter {
+    static inline int copies{0};
+    CopyCounter() = default;
+    CopyCounter(const CopyCounter &) { ++copies; }
+    CopyCounter(CopyCounter &&) = default;
+  };
+} // namespace
+
+SCENARIO("testing multicast_delegate argument passing") {
+  GIVEN("a delegate taking a by value argument") {
+    multicast_delegate<void(CopyCounter)> del;
+    WHEN("all callables take the argument by const reference") {
+      for (int i = 0; i < 50; ++i)
+        del.bind([](const CopyCounter &) {});
+      CopyCounter::copies = 0;
+      del(CopyCounter{});
+      THEN("the argument is never copied") {
+        REQUIRE(CopyCounter::copies == 0);
+      }
+      AND_WHEN("invoking it with an lvalue") {
+        CopyCounter c;
+        CopyCounter::copies = 0;
+        del(c);
+        THEN("the argument is copied once") {
+          REQUIRE(CopyCounter::copies == 1);
+        }
+      }
+    }
+    WHEN("all callables take the argument by value") {
+      for (int i = 0; i < 50; ++i)
+        del.bind([](CopyCounter) {});
+      CopyCounter::copies = 0;
+      del(CopyCounter{});
+      THEN("the argument is copied once per callable") {
+        REQUIRE(CopyCounter::copies == 50);
+      }
+    }
+  }
+}
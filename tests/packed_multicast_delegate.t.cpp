@@ -0,0 +1,119 @@
+/**
+ * @file packed_multicast_delegate.t.cpp
+ * @author Pele Constam (pelectron1602@gmail.com)
+ * @brief This file contains the tests for the packed_multicast_delegate class.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "packed_multicast_delegate.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace pc;
+
+namespace {
+  int square(int a) { return a * a; }
+  int negate(int a) { return -a; }
+
+  struct Adder {
+    int add(int a) const { return a + offset; }
+    int offset;
+  };
+
+  /// function object too large for the delegate's storage.
+  struct BigFunctor {
+    int operator()(int a) const { return a + static_cast<int>(padding[0]); }
+    long long padding[8]{};
+  };
+} // namespace
+
+#include "catch2/catch.hpp"
+SCENARIO("testing packed_multicast_delegate") {
+  GIVEN("a packed_multicast_delegate with mixed kinds of callables") {
+    packed_multicast_delegate<int(int)> del;
+    REQUIRE(del.num_callables() == 0);
+    Adder adder{10};
+    BigFunctor big;
+    big.padding[0] = 100;
+    auto shared = std::make_shared<int>(1000);
+    del.bind(&square);
+    del.bind(adder, &Adder::add);
+    del.bind([shared](int a) { return a + *shared; });
+    del.bind(big);
+    del.bind(&negate);
+    del.bind([](int a) { return a * 2; });
+    del.bind(&square);
+    REQUIRE(del.num_callables() == 7);
+    WHEN("invoking it") {
+      del(3);
+      THEN("every callable is invoked in bind order") {
+        std::vector<int> results(del.begin(), del.end());
+        REQUIRE(results == std::vector<int>{9, 13, 1003, 103, -3, 6, 9});
+      }
+    }
+    WHEN("grouping the callables by target") {
+      del.group_by_target();
+      del(3);
+      THEN("the same callables are invoked, same targets adjacent") {
+        std::vector<int> results(del.begin(), del.end());
+        REQUIRE(results.size() == 7);
+        std::vector<int> sorted = results;
+        std::sort(sorted.begin(), sorted.end());
+        REQUIRE(sorted == std::vector<int>{-3, 6, 9, 9, 13, 103, 1003});
+        // all free functions share one invoke function, their relative order
+        // is kept.
+        auto first = std::find(results.begin(), results.end(), 9);
+        REQUIRE(std::vector<int>(first, first + 3) ==
+                std::vector<int>{9, -3, 9});
+      }
+    }
+    WHEN("copying it") {
+      auto copy = del;
+      REQUIRE(shared.use_count() == 3);
+      copy(1);
+      THEN("the copy invokes the same callables") {
+        std::vector<int> results(copy.begin(), copy.end());
+        REQUIRE(results == std::vector<int>{1, 11, 1001, 101, -1, 2, 1});
+      }
+    }
+    WHEN("moving it") {
+      auto moved = std::move(del);
+      REQUIRE(shared.use_count() == 2);
+      REQUIRE(del.num_callables() == 0);
+      moved(2);
+      THEN("the moved to instance invokes the callables") {
+        REQUIRE(moved.num_results() == 7);
+      }
+    }
+    WHEN("resetting it") {
+      del.reset();
+      THEN("the callables are destroyed") {
+        REQUIRE(del.num_callables() == 0);
+        REQUIRE(shared.use_count() == 1);
+      }
+    }
+  }
+  GIVEN("a packed_multicast_delegate growing past its capacity") {
+    packed_multicast_delegate<void(std::string&)> del;
+    for (int i = 0; i < 100; ++i)
+      del.bind([s = std::to_string(i % 10)](std::string& out) { out += s; });
+    WHEN("invoking it") {
+      std::string out;
+      del(out);
+      THEN("every relocated callable still works") {
+        std::string expected;
+        for (int i = 0; i < 10; ++i)
+          expected += "0123456789";
+        REQUIRE(out == expected);
+      }
+    }
+  }
+}
@@ -0,0 +1,112 @@
+/**
+ * @file sharded_multicast_delegate.t.cpp
+ * @author Pele Constam (pelectron1602@gmail.com)
+ * @brief This file contains the tests for the sharded_multicast_delegate
+ * class.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "sharded_multicast_delegate.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace pc;
+
+#include "catch2/catch.hpp"
+
+static int times_two(int x) { return 2 * x; }
+
+SCENARIO("testing sharded_multicast_delegate") {
+  GIVEN("a sharded_multicast_delegate with four shards") {
+    sharded_multicast_delegate<int(int)> d(4);
+    REQUIRE(d.num_shards() == 4);
+    REQUIRE(d.num_callables() == 0);
+    WHEN("binding callables and invoking it") {
+      d.bind(&times_two);
+      const auto id = d.bind([](int x) { return x + 1; });
+      d(10);
+      THEN("the results of all callables are collected") {
+        REQUIRE(d.num_callables() == 2);
+        REQUIRE(d.num_results() == 2);
+        REQUIRE(d.take_results() == std::vector<int>{20, 11});
+        REQUIRE(d.num_results() == 0);
+      }
+      AND_WHEN("unbinding one of them") {
+        REQUIRE(d.unbind(id));
+        REQUIRE_FALSE(d.unbind(id));
+        d.clear_results();
+        d(3);
+        THEN("only the other one is invoked") {
+          REQUIRE(d.take_results() == std::vector<int>{6});
+        }
+      }
+      AND_WHEN("resetting it") {
+        d.reset();
+        d.clear_results();
+        d(3);
+        THEN("nothing is invoked") {
+          REQUIRE(d.num_callables() == 0);
+          REQUIRE(d.num_results() == 0);
+        }
+      }
+    }
+  }
+  GIVEN("several threads invoking the same sharded_multicast_delegate") {
+    constexpr int                         num_threads = 6;
+    constexpr int                         num_emits = 1000;
+    sharded_multicast_delegate<int(int)>  d(4);
+    std::atomic<int>                      calls{0};
+    sharded_multicast_delegate<void(int)> counter(4);
+    d.bind(&times_two);
+    counter.bind([&calls](int) { calls.fetch_add(1); });
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+      threads.emplace_back([&, t] {
+        for (int i = 0; i < num_emits; ++i) {
+          d(t);
+          counter(t);
+        }
+      });
+    }
+    for (auto& t : threads)
+      t.join();
+    THEN("every invocation is collected exactly once") {
+      REQUIRE(calls.load() == num_threads * num_emits);
+      auto results = d.take_results();
+      REQUIRE(results.size() == size_t{num_threads * num_emits});
+      for (int t = 0; t < num_threads; ++t)
+        REQUIRE(std::count(results.begin(), results.end(), 2 * t) == num_emits);
+    }
+  }
+  GIVEN("a writer binding while other threads invoke") {
+    sharded_multicast_delegate<int(int)> d(2);
+    d.bind(&times_two);
+    std::atomic<bool>        done{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; ++t) {
+      threads.emplace_back([&] {
+        while (!done.load())
+          d(1);
+      });
+    }
+    for (int i = 0; i < 100; ++i)
+      d.unbind(d.bind(&times_two));
+    done.store(true);
+    for (auto& t : threads)
+      t.join();
+    THEN("the replicas stay consistent") {
+      REQUIRE(d.num_callables() == 1);
+      auto results = d.take_results();
+      REQUIRE(std::all_of(results.begin(), results.end(),
+                          [](int r) { return r == 2; }));
+    }
+  }
+}
@@ -0,0 +1,67 @@
+/**
+ * @file static_multicast.t.cpp
+ * @author Pele Constam (pelectron1602@gmail.com)
+ * @brief This file contains the tests for the static_multicast class.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "static_multicast.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace pc;
+
+namespace {
+  int square(int a) { return a * a; }
+
+  struct Accumulator {
+    int operator()(int a) {
+      total += a;
+      return total;
+    }
+    int total{0};
+  };
+} // namespace
+
+#include "catch2/catch.hpp"
+SCENARIO("testing static_multicast") {
+  GIVEN("a static_multicast with a free function, a lambda and a functor") {
+    auto del = make_static_multicast<int(int)>(
+        &square, [](int a) { return a + 1; }, Accumulator{});
+    STATIC_REQUIRE(decltype(del)::num_callables() == 3);
+    REQUIRE(del.num_results() == 0);
+    WHEN("invoking it twice") {
+      del(3);
+      del(4);
+      THEN("the results are collected in order") {
+        std::vector<int> results(del.begin(), del.end());
+        REQUIRE(results == std::vector<int>{9, 4, 3, 16, 5, 7});
+        REQUIRE(std::vector<int>(del.cbegin(), del.cend()) == results);
+        REQUIRE(del.get<2>().total == 7);
+      }
+      AND_WHEN("clearing the results") {
+        del.clear_results();
+        THEN("no results are stored") { REQUIRE(del.num_results() == 0); }
+      }
+    }
+  }
+  GIVEN("a static_multicast returning void") {
+    std::string out;
+    auto        del = make_static_multicast<void(const std::string&)>(
+        [&out](const std::string& s) { out += s; },
+        [&out](const std::string& s) { out += s + "!"; });
+    WHEN("invoking it") {
+      del("hi");
+      THEN("every callable is invoked in order") {
+        REQUIRE(out == "hihi!");
+        REQUIRE(del.num_results() == 0);
+      }
+    }
+  }
+}
@@ -0,0 +1,145 @@
+/**
+ * @file task_scheduler.t.cpp
+ * @author Pele Constam (pelectron1602@gmail.com)
+ * @brief This file contains the tests for the task_scheduler class.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "multicast_delegate.hpp"
+#include "task_scheduler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+using namespace pc;
+
+namespace {
+  long fib(task_scheduler& s, int n) {
+    if (n < 2)
+      return n;
+    wait_group wg;
+    long       a = 0;
+    s.spawn(wg, [&s, &a, n] { a = fib(s, n - 1); });
+    const long b = fib(s, n - 2);
+    s.wait(wg);
+    return a + b;
+  }
+} // namespace
+
+#include "catch2/catch.hpp"
+SCENARIO("testing work_stealing_deque") {
+  impl::work_stealing_deque<int> deque(2);
+  int                            values[3] = {0, 1, 2};
+  REQUIRE(deque.push(&values[0]));
+  REQUIRE(deque.push(&values[1]));
+  REQUIRE_FALSE(deque.push(&values[2]));
+  REQUIRE(deque.steal() == &values[0]);
+  REQUIRE(deque.pop() == &values[1]);
+  REQUIRE(deque.pop() == nullptr);
+  REQUIRE(deque.steal() == nullptr);
+}
+
+SCENARIO("testing task_scheduler") {
+  GIVEN("a task_scheduler") {
+    task_scheduler scheduler(3);
+    REQUIRE(scheduler.num_workers() == 3);
+    WHEN("spawning tasks into a wait_group from outside") {
+      std::atomic<int> count{0};
+      wait_group       wg;
+      for (int i = 0; i < 1000; ++i)
+        scheduler.spawn(wg, [&count](int a) { count.fetch_add(a); }, 1);
+      scheduler.wait(wg);
+      THEN("all tasks are run") {
+        REQUIRE(wg.count() == 0);
+        REQUIRE(count.load() == 1000);
+      }
+    }
+    WHEN("tasks fork and join recursively") {
+      THEN("the result is correct") { REQUIRE(fib(scheduler, 20) == 6765); }
+    }
+    WHEN("running a parallel_for") {
+      std::vector<int> v(10000, 0);
+      scheduler.parallel_for(0, v.size(), 100,
+                             [&v](size_t first, size_t last) {
+                               for (size_t i = first; i < last; ++i)
+                                 v[i] += 1;
+                             });
+      THEN("every index is visited exactly once") {
+        REQUIRE(std::count(v.begin(), v.end(), 1) == 10000);
+      }
+    }
+    WHEN("spawning a move-only callable") {
+      auto       value = std::make_unique<int>(7);
+      int        result = 0;
+      wait_group wg;
+      scheduler.spawn(
+          wg, [&result](std::unique_ptr<int> p) { result = *p; },
+          std::move(value));
+      scheduler.wait(wg);
+      THEN("it is moved into the task") { REQUIRE(result == 7); }
+    }
+#ifndef PC_DELEGATE_NO_EXCEPTIONS
+    WHEN("tasks of a wait_group throw") {
+      std::atomic<int> count{0};
+      wait_group       wg;
+      for (int i = 0; i < 1000; ++i) {
+        scheduler.spawn(wg, [&count, i] {
+          if (i % 100 == 0)
+            throw std::runtime_error("task");
+          count.fetch_add(1);
+        });
+      }
+      THEN("wait() finishes all tasks and rethrows the first exception") {
+        REQUIRE_THROWS_AS(scheduler.wait(wg), std::runtime_error);
+        REQUIRE(wg.count() == 0);
+        REQUIRE(count.load() == 990);
+        AND_THEN("the wait_group and the workers can be used again") {
+          scheduler.spawn(wg, [&count] { count.fetch_add(1); });
+          REQUIRE_NOTHROW(scheduler.wait(wg));
+          REQUIRE(count.load() == 991);
+        }
+      }
+    }
+    WHEN("a parallel_for body throws") {
+      THEN("parallel_for rethrows once all chunks are done") {
+        REQUIRE_THROWS_AS(scheduler.parallel_for(0, 1000, 10,
+                                                 [](size_t first, size_t) {
+                                                   if (first == 500)
+                                                     throw std::runtime_error(
+                                                         "chunk");
+                                                 }),
+                          std::runtime_error);
+      }
+    }
+#endif
+    WHEN("using it as the executor of parallel_invoke") {
+      multicast_delegate<int(int)> del;
+      for (int i = 0; i < 100; ++i)
+        del.bind([i](int a) { return a + i; });
+      del.parallel_invoke(scheduler, 1);
+      THEN("the results are the same as when invoking serially") {
+        int i = 0;
+        for (auto r : del)
+          REQUIRE(r == 1 + i++);
+        REQUIRE(i == 100);
+      }
+    }
+  }
+  GIVEN("a task_scheduler with pending tasks") {
+    std::atomic<int> count{0};
+    {
+      task_scheduler scheduler(2);
+      for (int i = 0; i < 100; ++i)
+        scheduler.spawn([&count] { count.fetch_add(1); });
+    }
+    THEN("destroying it runs all tasks") { REQUIRE(count.load() == 100); }
+  }
+}
@@ -0,0 +1,63 @@
+/**
+ * @file thread_pool.t.cpp
+ * @author Pele Constam (pelectron1602@gmail.com)
+ * @brief This file contains the tests for the thread_pool class.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "thread_pool.hpp"
+
+#include <atomic>
+#include <thread>
+
+using namespace pc;
+
+#include "catch2/catch.hpp"
+SCENARIO("testing thread_pool") {
+  GIVEN("a thread_pool") {
+    thread_pool pool(3);
+    REQUIRE(pool.num_workers() == 3);
+    WHEN("submitting tasks") {
+      std::atomic<int> count{0};
+      for (int i = 0; i < 1000; ++i)
+        pool.submit([&count] { count.fetch_add(1); });
+      THEN("all tasks are executed") {
+        while (count.load() != 1000) {
+          if (!pool.try_run_one())
+            std::this_thread::yield();
+        }
+        REQUIRE(count.load() == 1000);
+      }
+    }
+    WHEN("tasks submit further tasks") {
+      std::atomic<int> count{0};
+      for (int i = 0; i < 10; ++i) {
+        pool.submit([&pool, &count] {
+          for (int j = 0; j < 10; ++j)
+            pool.submit([&count] { count.fetch_add(1); });
+        });
+      }
+      THEN("all tasks are executed") {
+        while (count.load() != 100) {
+          if (!pool.try_run_one())
+            std::this_thread::yield();
+        }
+        REQUIRE(count.load() == 100);
+      }
+    }
+  }
+  GIVEN("a thread_pool with pending tasks") {
+    std::atomic<int> count{0};
+    {
+      thread_pool pool(2);
+      for (int i = 0; i < 100; ++i)
+        pool.submit([&count] { count.fetch_add(1); });
+    }
+    THEN("destroying it runs all tasks") { REQUIRE(count.load() == 100); }
+  }
+}
@@ -0,0 +1,134 @@
+/**
+ * @file timer_wheel.t.cpp
+ * @author Pele Constam (pelectron1602@gmail.com)
+ * @brief This file contains the tests for the timer_wheel class.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "timer_wheel.hpp"
+
+#include <random>
+#include <vector>
+
+using namespace pc;
+
+#include "catch2/catch.hpp"
+SCENARIO("testing timer_wheel") {
+  GIVEN("an empty timer_wheel") {
+    timer_wheel wheel;
+    REQUIRE(wheel.empty());
+    REQUIRE(wheel.now() == 0);
+    WHEN("advancing") {
+      REQUIRE(wheel.advance(1000) == 0);
+      THEN("the current tick moves") { REQUIRE(wheel.now() == 1000); }
+    }
+    WHEN("scheduling a timer") {
+      int  fired = 0;
+      auto id = wheel.schedule(10, [&fired] { ++fired; });
+      REQUIRE(id != timer_wheel::invalid_timer);
+      REQUIRE(wheel.size() == 1);
+      THEN("it fires after the delay") {
+        REQUIRE(wheel.advance(9) == 0);
+        REQUIRE(fired == 0);
+        REQUIRE(wheel.advance(1) == 1);
+        REQUIRE(fired == 1);
+        REQUIRE(wheel.empty());
+        AND_THEN("cancelling it afterwards does nothing") {
+          REQUIRE_FALSE(wheel.cancel(id));
+        }
+      }
+      THEN("cancelling it prevents it from firing") {
+        REQUIRE(wheel.cancel(id));
+        REQUIRE_FALSE(wheel.cancel(id));
+        REQUIRE(wheel.empty());
+        wheel.advance(20);
+        REQUIRE(fired == 0);
+      }
+    }
+    WHEN("scheduling a timer with a delay of 0") {
+      int fired = 0;
+      wheel.schedule(0, [&fired] { ++fired; });
+      THEN("it fires on the next tick") {
+        REQUIRE(fired == 0);
+        REQUIRE(wheel.advance(1) == 1);
+        REQUIRE(fired == 1);
+      }
+    }
+  }
+  GIVEN("timers on every level and in the overflow list") {
+    timer_wheel                 wheel(12345);
+    std::vector<uint64_t>       fired_at;
+    const std::vector<uint64_t> delays{1,
+                                       255,
+                                       256,
+                                       257,
+                                       65535,
+                                       65536,
+                                       70000,
+                                       1u << 24,
+                                       (1u << 24) + 3,
+                                       4000000000u,
+                                       (uint64_t{1} << 32) + 5};
+    for (auto d : delays) {
+      wheel.schedule(d,
+                     [&wheel, &fired_at] { fired_at.push_back(wheel.now()); });
+    }
+    THEN("each fires exactly at its expiry") {
+      // advancing in uneven steps must not matter.
+      while (!wheel.empty())
+        wheel.advance(wheel.now() % 3 == 0 ? 1 : 977);
+      REQUIRE(fired_at.size() == delays.size());
+      for (size_t i = 0; i < delays.size(); ++i)
+        REQUIRE(fired_at[i] == 12345 + delays[i]);
+    }
+  }
+  GIVEN("a timer_wheel and a callback scheduling and cancelling timers") {
+    timer_wheel           wheel;
+    std::vector<int>      order;
+    timer_wheel::timer_id victim = timer_wheel::invalid_timer;
+    wheel.schedule(5, [&] {
+      order.push_back(1);
+      REQUIRE(wheel.cancel(victim));
+      wheel.schedule(1, [&order] { order.push_back(3); });
+    });
+    victim = wheel.schedule(5, [&order] { order.push_back(2); });
+    THEN("changes made while expiring are respected") {
+      REQUIRE(wheel.advance(5) == 1);
+      REQUIRE(wheel.advance(1) == 1);
+      REQUIRE(order == std::vector<int>{1, 3});
+    }
+  }
+  GIVEN("many random timers, most of them cancelled") {
+    timer_wheel                        wheel;
+    std::mt19937_64                    rng(42);
+    std::vector<timer_wheel::timer_id> ids;
+    std::vector<uint64_t>              expiry;
+    std::vector<int>                   fired(10000, 0);
+    std::vector<bool>                  cancelled(10000, false);
+    for (int i = 0; i < 10000; ++i) {
+      const uint64_t delay = 1 + rng() % 100000;
+      expiry.push_back(delay);
+      ids.push_back(wheel.schedule(delay, [&wheel, &fired, &expiry, i] {
+        REQUIRE(wheel.now() == expiry[i]);
+        ++fired[i];
+      }));
+    }
+    for (int i = 0; i < 10000; ++i) {
+      if (rng() % 10 != 0) {
+        REQUIRE(wheel.cancel(ids[i]));
+        cancelled[i] = true;
+      }
+    }
+    THEN("exactly the remaining timers fire once") {
+      wheel.advance(100000);
+      REQUIRE(wheel.empty());
+      for (int i = 0; i < 10000; ++i)
+        REQUIRE(fired[i] == (cancelled[i] ? 0 : 1));
+    }
+  }
+}
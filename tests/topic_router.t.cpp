@@ -0,0 +1,114 @@
+/**
+ * @file topic_router.t.cpp
+ * @author Pele Constam (pelectron1602@gmail.com)
+ * @brief This file contains the tests for the topic_router class.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Copyright Pele Constam 2022.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "topic_router.hpp"
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace pc;
+
+#include "catch2/catch.hpp"
+SCENARIO("testing topic matching") {
+  REQUIRE(impl::topic_matches("orders.eu.created", "orders.eu.created"));
+  REQUIRE_FALSE(impl::topic_matches("orders.eu.created", "orders.eu"));
+  REQUIRE(impl::topic_matches("orders.*.created", "orders.us.created"));
+  REQUIRE_FALSE(impl::topic_matches("orders.*", "orders.eu.created"));
+  REQUIRE(impl::topic_matches("orders.#", "orders"));
+  REQUIRE(impl::topic_matches("orders.#", "orders.eu.created"));
+  REQUIRE(impl::topic_matches("#.created", "orders.eu.created"));
+  REQUIRE(impl::topic_matches("#", "orders.eu.created"));
+  REQUIRE_FALSE(impl::topic_matches("#.deleted", "orders.eu.created"));
+}
+
+SCENARIO("testing topic_router") {
+  GIVEN("a topic_router with wildcard subscriptions") {
+    topic_router<void(int)> router;
+    std::vector<std::string> calls;
+    auto record = [&calls](const char *name) {
+      return [&calls, name](int) { calls.push_back(name); };
+    };
+    router.subscribe("orders.eu.created", record("exact"));
+    auto star_id = router.subscribe("orders.eu.*", record("star"));
+    router.subscribe("orders.#", record("hash"));
+    router.subscribe("#.#", record("double hash"));
+    router.subscribe("users.*", record("users"));
+    REQUIRE(router.num_patterns() == 5);
+    WHEN("publishing a topic") {
+      router.publish("orders.eu.created", 1);
+      THEN("every matching channel is invoked once") {
+        REQUIRE(calls.size() == 4);
+        REQUIRE(std::count(calls.begin(), calls.end(), "users") == 0);
+        REQUIRE(std::count(calls.begin(), calls.end(), "double hash") == 1);
+        REQUIRE(router.num_cached_topics() == 1);
+      }
+    }
+    WHEN("publishing a topic given as a view into a temporary") {
+      router.publish(
+          std::string_view(std::string("orders.eu.created.x")).substr(0, 17),
+          1);
+      router.publish(std::string_view("orders.eu.created"), 2);
+      THEN("the topic is cached once and owned by the router") {
+        REQUIRE(calls.size() == 8);
+        REQUIRE(router.num_cached_topics() == 1);
+      }
+    }
+    WHEN("subscribing after the topic is cached") {
+      router.publish("orders.eu.created", 1);
+      calls.clear();
+      router.subscribe("*.eu.#", record("late"));
+      router.subscribe("users.#", record("other"));
+      router.publish("orders.eu.created", 2);
+      THEN("the cache entry is updated with the new channel only") {
+        REQUIRE(calls.size() == 5);
+        REQUIRE(std::count(calls.begin(), calls.end(), "late") == 1);
+        REQUIRE(std::count(calls.begin(), calls.end(), "other") == 0);
+      }
+    }
+    WHEN("unsubscribing the last callable of a pattern") {
+      router.publish("orders.eu.created", 1);
+      calls.clear();
+      REQUIRE(router.unsubscribe(star_id));
+      REQUIRE_FALSE(router.unsubscribe(star_id));
+      router.publish("orders.eu.created", 2);
+      THEN("its channel is removed") {
+        REQUIRE(router.channel("orders.eu.*") == nullptr);
+        REQUIRE(router.num_patterns() == 4);
+        REQUIRE(calls.size() == 3);
+        REQUIRE(std::count(calls.begin(), calls.end(), "star") == 0);
+      }
+    }
+  }
+  GIVEN("callables which modify the router while it publishes") {
+    topic_router<int(int)> router;
+    topic_router<int(int)>::subscription_id self_id = 0;
+    self_id = router.subscribe("a.*", [&](int a) {
+      router.unsubscribe(self_id);
+      router.subscribe("a.b", [](int b) { return b + 1; });
+      return a;
+    });
+    WHEN("publishing") {
+      router.publish("a.b", 1);
+      THEN("the changes take effect once publishing is done") {
+        REQUIRE(router.channel("a.*") == nullptr);
+        REQUIRE(router.num_patterns() == 1);
+        router.publish("a.b", 1);
+        auto *ch = router.channel("a.b");
+        REQUIRE(ch != nullptr);
+        REQUIRE(ch->num_results() == 1);
+        REQUIRE(*ch->begin() == 2);
+      }
+    }
+  }
+}